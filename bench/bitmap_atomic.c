@@ -0,0 +1,223 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Checks that concurrent bitmap_claim_first_free() calls never hand out
+ * the same bit twice, and compares claim/release throughput under
+ * contention against a bitmap protected by a global lock.
+ */
+
+#include <nanvix/barelib.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Number of bits in the bitmap.
+ */
+#define NBITS 4096
+
+/**
+ * @brief Number of bits left free in the timed runs.
+ */
+#define NFREE 64
+
+/**
+ * @brief Maximum number of threads.
+ */
+#define MAX_THREADS 8
+
+/**
+ * @brief Claim/release pairs per thread in the timed runs.
+ */
+#define NOPS 200000
+
+/**
+ * @brief Shared bitmap.
+ */
+static bitmap_t bitmap[NBITS/BITMAP_WORD_LENGTH];
+
+/**
+ * @brief Claimers of each bit in the check.
+ */
+static unsigned claims[NBITS];
+
+/**
+ * @brief Lock of the baseline.
+ */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Number of errors found.
+ */
+static unsigned errors = 0;
+
+/**
+ * @brief Returns the current time in nanoseconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec*1e9 + ts.tv_nsec);
+}
+
+/**
+ * @brief Claims bits until the bitmap is full.
+ */
+static void *claim_all(void *arg)
+{
+	bitmap_t pos;
+
+	((void) arg);
+
+	while ((pos = bitmap_claim_first_free(bitmap, sizeof(bitmap))) != BITMAP_FULL)
+		__atomic_fetch_add(&claims[pos], 1, __ATOMIC_RELAXED);
+
+	return (NULL);
+}
+
+/**
+ * @brief Claims and releases bits with atomic operations.
+ */
+static void *churn_atomic(void *arg)
+{
+	int i;
+	bitmap_t pos;
+
+	((void) arg);
+
+	for (i = 0; i < NOPS; i++)
+	{
+		if ((pos = bitmap_claim_first_free(bitmap, sizeof(bitmap))) == BITMAP_FULL)
+			continue;
+
+		if (!bitmap_test_and_clear(bitmap, pos))
+			__atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Claims and releases bits under a global lock.
+ */
+static void *churn_locked(void *arg)
+{
+	int i;
+	bitmap_t pos;
+
+	((void) arg);
+
+	for (i = 0; i < NOPS; i++)
+	{
+		pthread_mutex_lock(&lock);
+		pos = bitmap_first_free(bitmap, sizeof(bitmap));
+		if (pos != BITMAP_FULL)
+			bitmap_set(bitmap, pos);
+		pthread_mutex_unlock(&lock);
+
+		if (pos == BITMAP_FULL)
+			continue;
+
+		pthread_mutex_lock(&lock);
+		if (!bitmap_test(bitmap, pos))
+			errors++;
+		bitmap_clear(bitmap, pos);
+		pthread_mutex_unlock(&lock);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Runs a workload on some threads.
+ *
+ * @returns The elapsed time, in nanoseconds.
+ */
+static double spawn(void *(*fn)(void *), int nthreads)
+{
+	int i;
+	double t0;
+	pthread_t tids[MAX_THREADS];
+
+	t0 = now();
+	for (i = 0; i < nthreads; i++)
+		pthread_create(&tids[i], NULL, fn, NULL);
+	for (i = 0; i < nthreads; i++)
+		pthread_join(tids[i], NULL);
+
+	return (now() - t0);
+}
+
+/**
+ * @brief Fills the bitmap, leaving only its last bits free.
+ */
+static void prefill(void)
+{
+	__memset(bitmap, 0, sizeof(bitmap));
+	bitmap_set_range(bitmap, 0, NBITS - NFREE);
+}
+
+int main(void)
+{
+	int n;
+	unsigned i;
+
+	/* Every bit is claimed exactly once. */
+	__memset(bitmap, 0, sizeof(bitmap));
+	spawn(claim_all, MAX_THREADS);
+	for (i = 0; i < NBITS; i++)
+	{
+		if (claims[i] != 1)
+			errors++;
+	}
+	printf("claim check: %u threads, %u bits, %u errors\n", MAX_THREADS, NBITS, errors);
+
+	/* Throughput under contention. */
+	printf("claim/release pairs, %u of %u bits free:\n", NFREE, NBITS);
+	printf("  threads   atomic       global lock\n");
+	for (n = 1; n <= MAX_THREADS; n *= 2)
+	{
+		double tatomic, tlocked;
+
+		prefill();
+		tatomic = spawn(churn_atomic, n)/((double)n*NOPS);
+		prefill();
+		tlocked = spawn(churn_locked, n)/((double)n*NOPS);
+
+		printf("  %7d   %6.1f ns    %6.1f ns\n", n, tatomic, tlocked);
+	}
+
+	if (bitmap_nset(bitmap, sizeof(bitmap)) != (NBITS - NFREE))
+		errors++;
+
+	printf("errors: %u\n", errors);
+
+	return (errors != 0);
+}
@@ -0,0 +1,332 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Checks dividers for invariant integers against __udivmodsi4() and the
+ * hardware divider across edge divisors, and compares their throughput.
+ */
+
+#include <nanvix/barelib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Number of divisions per timed run.
+ */
+#define NDIVS (1 << 22)
+
+/**
+ * @brief Number of numerators in the timed runs.
+ */
+#define NNUMS 1024
+
+/**
+ * @brief Number of random numerators per checked divisor.
+ */
+#define NRANDOM 4096
+
+/**
+ * @brief Number of mismatches found.
+ */
+static unsigned failures = 0;
+
+/**
+ * @brief Returns a pseudo-random 64-bit number (xorshift64*).
+ */
+static uint64_t random64(void)
+{
+	static uint64_t x = 0x9e3779b97f4a7c15ULL;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+
+	return (x * 0x2545f4914f6cdd1dULL);
+}
+
+/**
+ * @brief Returns the current time in nanoseconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec*1e9 + ts.tv_nsec);
+}
+
+/**
+ * @brief Reports a mismatch.
+ */
+#define CHECK(cond, ...)              \
+	do                                \
+	{                                 \
+		if (!(cond))                  \
+		{                             \
+			if (failures++ < 16)      \
+				printf(__VA_ARGS__);  \
+		}                             \
+	} while (0)
+
+/*============================================================================*
+ * Checks                                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Checks a 32-bit unsigned divider on edge and random numerators.
+ */
+static void check_u32(uint32_t d)
+{
+	divu32_t div;
+	uint32_t nums[] = { 0, 1, d - 1, d, d + 1, 0x7fffffff, 0x80000000, UINT32_MAX - 1, UINT32_MAX };
+	unsigned i;
+
+	divu32_init(&div, d);
+
+	for (i = 0; i < sizeof(nums)/sizeof(nums[0]) + NRANDOM; i++)
+	{
+		uint32_t n = (i < sizeof(nums)/sizeof(nums[0])) ? nums[i] : (uint32_t)random64();
+
+		CHECK(divu32_div(&div, n) == n/d, "divu32: %u / %u\n", n, d);
+		CHECK(divu32_mod(&div, n) == n%d, "divu32: %u %% %u\n", n, d);
+		CHECK(divu32_div(&div, n) == __udivmodsi4(n, d, 0), "divu32: %u / %u vs __udivmodsi4\n", n, d);
+		CHECK(divu32_mod(&div, n) == __udivmodsi4(n, d, 1), "divu32: %u %% %u vs __udivmodsi4\n", n, d);
+	}
+}
+
+/**
+ * @brief Checks a 32-bit signed divider on edge and random numerators.
+ *
+ * @details The reference is computed in 64 bits and wrapped, so that
+ * INT32_MIN / -1 is INT32_MIN (and the remainder zero).
+ */
+static void check_s32(int32_t d)
+{
+	divs32_t div;
+	int32_t nums[] = { 0, 1, -1, d - 1, d, d + 1, INT32_MAX, INT32_MIN, INT32_MIN + 1 };
+	unsigned i;
+
+	divs32_init(&div, d);
+
+	for (i = 0; i < sizeof(nums)/sizeof(nums[0]) + NRANDOM; i++)
+	{
+		int32_t n = (i < sizeof(nums)/sizeof(nums[0])) ? nums[i] : (int32_t)random64();
+		int32_t q = (int32_t)(uint32_t)((int64_t)n/d);
+		int32_t r = (int32_t)((int64_t)n%d);
+
+		CHECK(divs32_div(&div, n) == q, "divs32: %d / %d\n", n, d);
+		CHECK(divs32_mod(&div, n) == r, "divs32: %d %% %d\n", n, d);
+	}
+}
+
+/**
+ * @brief Checks a 64-bit unsigned divider on edge and random numerators.
+ */
+static void check_u64(uint64_t d)
+{
+	divu64_t div;
+	uint64_t nums[] = { 0, 1, d - 1, d, d + 1, INT64_MAX, (uint64_t)INT64_MIN, UINT64_MAX - 1, UINT64_MAX };
+	unsigned i;
+
+	divu64_init(&div, d);
+
+	for (i = 0; i < sizeof(nums)/sizeof(nums[0]) + NRANDOM; i++)
+	{
+		uint64_t n = (i < sizeof(nums)/sizeof(nums[0])) ? nums[i] : random64() >> (i & 63);
+
+		CHECK(divu64_div(&div, n) == n/d, "divu64: %llu / %llu\n", (unsigned long long)n, (unsigned long long)d);
+		CHECK(divu64_mod(&div, n) == n%d, "divu64: %llu %% %llu\n", (unsigned long long)n, (unsigned long long)d);
+	}
+}
+
+/**
+ * @brief Checks a 64-bit signed divider on edge and random numerators.
+ */
+static void check_s64(int64_t d)
+{
+	divs64_t div;
+	int64_t nums[] = { 0, 1, -1, d - 1, d, d + 1, INT64_MAX, INT64_MIN, INT64_MIN + 1 };
+	unsigned i;
+
+	divs64_init(&div, d);
+
+	for (i = 0; i < sizeof(nums)/sizeof(nums[0]) + NRANDOM; i++)
+	{
+		int64_t n = (i < sizeof(nums)/sizeof(nums[0])) ? nums[i] : (int64_t)(random64() >> (i & 63));
+		int64_t q, r;
+
+		/* INT64_MIN / -1 wraps around. */
+		if ((n == INT64_MIN) && (d == -1))
+		{
+			q = INT64_MIN;
+			r = 0;
+		}
+		else
+		{
+			q = n/d;
+			r = n%d;
+		}
+
+		CHECK(divs64_div(&div, n) == q, "divs64: %lld / %lld\n", (long long)n, (long long)d);
+		CHECK(divs64_mod(&div, n) == r, "divs64: %lld %% %lld\n", (long long)n, (long long)d);
+	}
+}
+
+/**
+ * @brief Checks all dividers across edge divisors.
+ */
+static void check(void)
+{
+	static const uint32_t u32[] = {
+		1, 2, 3, 5, 6, 7, 10, 11, 100, 641, 1000, 6700417,
+		0x7fffffff, 0x80000000, 0x80000001, UINT32_MAX - 1, UINT32_MAX
+	};
+	static const int32_t s32[] = {
+		1, -1, 2, -2, 3, -3, 7, -7, 10, -10, 641, -641,
+		INT32_MAX, -INT32_MAX, INT32_MIN, INT32_MIN + 1
+	};
+	static const uint64_t u64[] = {
+		1, 2, 3, 7, 10, 641, 0xffffffffULL, 0x100000000ULL, 0x100000001ULL,
+		INT64_MAX, (uint64_t)INT64_MIN, UINT64_MAX - 1, UINT64_MAX
+	};
+	static const int64_t s64[] = {
+		1, -1, 2, -2, 3, -3, 7, -7, 10, -10, 0x100000000LL, -0x100000000LL,
+		INT64_MAX, -INT64_MAX, INT64_MIN, INT64_MIN + 1
+	};
+	unsigned i, k;
+
+	for (i = 0; i < sizeof(u32)/sizeof(u32[0]); i++)
+		check_u32(u32[i]);
+	for (i = 0; i < sizeof(s32)/sizeof(s32[0]); i++)
+		check_s32(s32[i]);
+	for (i = 0; i < sizeof(u64)/sizeof(u64[0]); i++)
+		check_u64(u64[i]);
+	for (i = 0; i < sizeof(s64)/sizeof(s64[0]); i++)
+		check_s64(s64[i]);
+
+	/* Powers of two. */
+	for (k = 0; k < 32; k++)
+	{
+		check_u32(1U << k);
+		check_s32((int32_t)(1U << k));
+		check_s32(-(int32_t)(1U << (k & 30)));
+	}
+	for (k = 0; k < 64; k++)
+	{
+		check_u64(1ULL << k);
+		check_s64((int64_t)(1ULL << k));
+	}
+
+	/* INT32_MIN / -1 wraps around. */
+	{
+		divs32_t div;
+
+		divs32_init(&div, -1);
+		CHECK(divs32_div(&div, INT32_MIN) == INT32_MIN, "divs32: INT32_MIN / -1\n");
+		CHECK(divs32_mod(&div, INT32_MIN) == 0, "divs32: INT32_MIN %% -1\n");
+	}
+}
+
+/*============================================================================*
+ * Benchmark                                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Numerators of the timed runs.
+ */
+static uint32_t nums32[NNUMS];
+static uint64_t nums64[NNUMS];
+
+/**
+ * @brief Divisor of the timed runs (volatile, so it is not folded).
+ */
+static volatile uint32_t divisor32 = 7;
+static volatile uint64_t divisor64 = 1000000007ULL;
+
+/**
+ * @brief Sink for results of the timed runs.
+ */
+static volatile uint64_t sink;
+
+/**
+ * @brief Times a division loop.
+ */
+#define TIME(name, expr)                                 \
+	do                                                   \
+	{                                                    \
+		uint64_t acc = 0;                                \
+		double t0 = now();                               \
+		for (i = 0; i < NDIVS; i++)                      \
+			acc += (expr);                               \
+		sink = acc;                                      \
+		printf("  %-28s %6.2f ns/div\n", name,           \
+			(now() - t0)/NDIVS);                         \
+	} while (0)
+
+/**
+ * @brief Compares the throughput of the dividers against __udivmodsi4()
+ * and the hardware divider.
+ */
+static void bench(void)
+{
+	unsigned i;
+	uint32_t d32 = divisor32;
+	uint64_t d64 = divisor64;
+	divu32_t u32;
+	divu64_t u64;
+
+	for (i = 0; i < NNUMS; i++)
+	{
+		nums32[i] = (uint32_t)random64();
+		nums64[i] = random64();
+	}
+
+	divu32_init(&u32, d32);
+	divu64_init(&u64, d64);
+
+	printf("32-bit unsigned, divisor %u:\n", d32);
+	TIME("__udivmodsi4()", __udivmodsi4(nums32[i % NNUMS], divisor32, 0));
+	TIME("hardware /", nums32[i % NNUMS]/divisor32);
+	TIME("divu32_div()", divu32_div(&u32, nums32[i % NNUMS]));
+
+	printf("64-bit unsigned, divisor %llu:\n", (unsigned long long)d64);
+	TIME("hardware /", nums64[i % NNUMS]/divisor64);
+	TIME("divu64_div()", divu64_div(&u64, nums64[i % NNUMS]));
+}
+
+/*============================================================================*
+ * Main                                                                       *
+ *============================================================================*/
+
+int main(void)
+{
+	check();
+	printf("divider checks: %u mismatches\n", failures);
+
+	bench();
+
+	return (failures != 0);
+}
@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Compares first-free search latency of a flat bitmap against that of a
+ * hierarchical bitmap, at increasing occupancy.
+ */
+
+#include <nanvix/barelib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Number of bits in the bitmaps (16 GiB of 1 KiB frames).
+ */
+#define NBITS (1UL << 24)
+
+/**
+ * @brief Number of searches per timed run.
+ */
+#define NSEARCHES 2000
+
+/**
+ * @brief Returns a pseudo-random 64-bit number (xorshift64*).
+ */
+static uint64_t random64(void)
+{
+	static uint64_t x = 0x9e3779b97f4a7c15ULL;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+
+	return (x * 0x2545f4914f6cdd1dULL);
+}
+
+/**
+ * @brief Returns the current time in nanoseconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec*1e9 + ts.tv_nsec);
+}
+
+/**
+ * @brief Fills both bitmaps up to some occupancy and times searches.
+ *
+ * @details With a prefix fill, the first @p percent of the bits are
+ * set, as a first-fit allocator leaves them. With a random fill, each
+ * bit is set with probability @p percent. The search results of both
+ * bitmaps are checked against each other.
+ */
+static int run(bitmap_t *flat, hbitmap_t *hb, bitmap_t *storage, unsigned percent, int prefix)
+{
+	size_t i;
+	bitmap_t a = 0, b = 0;
+	double t0, tflat, thb;
+
+	__memset(flat, 0, NBITS/8);
+	hbitmap_init(hb, storage, NBITS);
+
+	for (i = 0; i < NBITS; i++)
+	{
+		int set = prefix ? (i < NBITS/100*percent) : ((random64() % 100) < percent);
+
+		if (set)
+		{
+			bitmap_set(flat, i);
+			hbitmap_set(hb, i);
+		}
+	}
+
+	t0 = now();
+	for (i = 0; i < NSEARCHES; i++)
+		a += bitmap_first_free(flat, NBITS/8);
+	tflat = (now() - t0)/NSEARCHES;
+
+	t0 = now();
+	for (i = 0; i < NSEARCHES; i++)
+		b += hbitmap_first_free(hb);
+	thb = (now() - t0)/NSEARCHES;
+
+	printf("  %-6s %3u%%   %10.1f ns   %8.1f ns\n",
+		prefix ? "prefix" : "random", percent, tflat, thb);
+
+	return (a != b);
+}
+
+int main(void)
+{
+	static const unsigned occupancy[] = { 50, 90, 99 };
+	bitmap_t *flat;
+	bitmap_t *storage;
+	hbitmap_t hb;
+	unsigned i;
+	int err = 0;
+
+	flat = malloc(NBITS/8);
+	storage = malloc(hbitmap_size(NBITS));
+	if ((flat == NULL) || (storage == NULL))
+		return (1);
+
+	printf("first-free latency, %lu bits:\n", NBITS);
+	printf("  fill   occ.   bitmap_first_free  hbitmap_first_free\n");
+
+	for (i = 0; i < sizeof(occupancy)/sizeof(occupancy[0]); i++)
+		err |= run(flat, &hb, storage, occupancy[i], 1);
+	for (i = 0; i < sizeof(occupancy)/sizeof(occupancy[0]); i++)
+		err |= run(flat, &hb, storage, occupancy[i], 0);
+
+	if (err)
+		printf("hbitmap: search results differ from flat bitmap\n");
+
+	free(storage);
+	free(flat);
+
+	return (err);
+}
@@ -77,6 +77,34 @@
 	 */
 	extern void *__memcpy(void *s1, const void *s2, size_t n);
 
+	/**
+	 * @brief Copy bytes in memory bypassing caches.
+	 *
+	 * @param s1 Target memory area.
+	 * @param s2 Source memory area.
+	 * @param n  Number of bytes to be copied.
+	 *
+	 * @returns A pointer to the target memory area.
+	 *
+	 * @note On targets that lack non-temporal stores, this is the
+	 * same as __memcpy().
+	 */
+	extern void *__memcpy_nt(void *s1, const void *s2, size_t n);
+
+	/**
+	 * @brief Finds an object in memory.
+	 *
+	 * @param haystack Target memory area.
+	 * @param hlen     Size (in bytes) of @p haystack.
+	 * @param needle   Object to look for.
+	 * @param nlen     Size (in bytes) of @p needle.
+	 *
+	 * @returns A pointer to the located object, or a null pointer if
+	 * the object does not occur in @p haystack. If @p nlen is zero,
+	 * @p haystack is returned.
+	 */
+	extern void *__memmem(const void *haystack, size_t hlen, const void *needle, size_t nlen);
+
 	/**
 	 * @brief Copies bytes in memory with overlapping areas.
 	 *
@@ -99,6 +127,20 @@
 	 */
 	extern void *__memset(void *s, int c, size_t n);
 
+	/**
+	 * @brief Sets bytes in memory bypassing caches.
+	 *
+	 * @param s Pointer to target memory area.
+	 * @param c Character to use.
+	 * @param n Number of bytes to be set.
+	 *
+	 * @returns A pointer to the target memory area.
+	 *
+	 * @note On targets that lack non-temporal stores, this is the
+	 * same as __memset().
+	 */
+	extern void *__memset_nt(void *s, int c, size_t n);
+
 /**@}*/
 
 /*============================================================================*
@@ -111,6 +153,19 @@
  */
 /**@{*/
 
+	/**
+	 * @name Long Word Scanning Operators
+	 *
+	 * @details Helpers of the string scanners that inspect a long word
+	 * at a time, using the has-zero-byte trick.
+	 */
+	/**@{*/
+	#define WORD_UNALIGNED(x) ((long)(x) & (sizeof(long) - 1)) /**< Nonzero if @p x is not aligned on a long word. */
+	#define WORD_ONES         (~0UL / 0xff)                      /**< Long word with all bytes set to 0x01.         */
+	#define WORD_HIGHS        (WORD_ONES << 7)                   /**< Long word with all bytes set to 0x80.         */
+	#define WORD_HAS_NULL(x)  (((x) - WORD_ONES) & ~(x) & WORD_HIGHS) /**< Nonzero if @p x has a null byte.  */
+	/**@}*/
+
 	/**
 	 * @brief Concatenates two strings.
 	 *
@@ -276,6 +331,26 @@
  */
 /**@{*/
 
+	/**
+	 * @brief Output sink of the formatter.
+	 *
+	 * @param ctx Context of the sink.
+	 * @param buf Formatted characters (not null-terminated).
+	 * @param len Number of characters in @p buf.
+	 */
+	typedef void (*fmt_sink_t)(void *ctx, const char *buf, size_t len);
+
+	/**
+	 * @brief Formats a string into an output sink.
+	 *
+	 * @param write Output sink.
+	 * @param ctx   Context passed to @p write.
+	 * @param fmt   Formatted string.
+	 *
+	 * @returns The number of characters emitted.
+	 */
+	extern int __cbprintf(fmt_sink_t write, void *ctx, const char *fmt, ...);
+
 	/**
 	 * @brief Formats a string.
 	 *
@@ -286,20 +361,287 @@
 	 */
 	extern int __sprintf(char *str, const char *fmt, ...);
 
+	/**
+	 * @brief Formats a string into an output sink.
+	 *
+	 * @param write Output sink.
+	 * @param ctx   Context passed to @p write.
+	 * @param fmt   Formatted string.
+	 * @param args  Variable arguments list.
+	 *
+	 * @returns The number of characters emitted.
+	 */
+	extern int __vcbprintf(fmt_sink_t write, void *ctx, const char *fmt, va_list args);
+
 	/**
 	 * @brief Writes at most size bytes of formatted data to str.
 	 *
-	 * @param str	Output string.
+	 * @param str	Output string (may be NULL if @p size is zero).
 	 * @param size	Write at most size bytes (including null byte).
 	 * @param fmt	Formatted string.
 	 * @param args	Variable arguments list.
 	 *
-	 * @returns Length of output string.
+	 * @returns Length of the untruncated output string.
+	 *
+	 * @note Every use of the l modifier takes a long, which is 32-bit on
+	 * ILP32 targets (e.g. riscv32 and mppa256). There, print 64-bit
+	 * integers with the legacy %L and %Lx forms, or with %llu and %llx.
 	 */
 	extern int __vsnprintf(char *str, size_t size, const char *fmt, va_list args);
 
 /**@}*/
 
+/*============================================================================*
+ * Precompiled Formats                                                        *
+ *============================================================================*/
+
+/**
+ * @addtogroup barelib-fmtdesc Precompiled Formats
+ * @ingroup barelib
+ *
+ * @details A format descriptor holds a format string parsed once into
+ * a list of operations, either literal runs or conversions. Formatting
+ * with a descriptor skips parsing altogether, which pays off for the
+ * format strings of hot paths.
+ */
+/**@{*/
+
+	/**
+	 * @brief Maximum number of operations in a format descriptor.
+	 */
+	#define FMT_DESC_MAX_OPS 16
+
+	/**
+	 * @brief Operation of a format descriptor.
+	 */
+	typedef struct
+	{
+		const char *lit;      /**< Literal run (NULL for a conversion). */
+		size_t len;           /**< Length of the literal run.           */
+		char conv;            /**< Conversion.                          */
+		unsigned char flags;  /**< Flags of the conversion.             */
+		unsigned char length; /**< Length modifier of the conversion.   */
+		unsigned char arg;    /**< Kind of argument of the conversion.  */
+		int width;            /**< Field width of the conversion.       */
+		int precision;        /**< Precision of the conversion.         */
+	} fmt_op_t;
+
+	/**
+	 * @brief Format descriptor.
+	 */
+	typedef struct
+	{
+		unsigned nops;                  /**< Number of operations. */
+		fmt_op_t ops[FMT_DESC_MAX_OPS]; /**< Operations.           */
+	} fmt_desc_t;
+
+	/**
+	 * @brief Compiles a format string into a format descriptor.
+	 *
+	 * @param desc Target format descriptor.
+	 * @param fmt  Formatted string (must outlive @p desc).
+	 *
+	 * @returns Zero on success, and -1 if @p fmt is NULL or it needs
+	 * more than #FMT_DESC_MAX_OPS operations.
+	 */
+	extern int fmt_compile(fmt_desc_t *desc, const char *fmt);
+
+	/**
+	 * @brief Formats arguments with a format descriptor into an output sink.
+	 *
+	 * @param write Output sink.
+	 * @param ctx   Context passed to @p write.
+	 * @param desc  Format descriptor.
+	 *
+	 * @returns The number of characters emitted, or -1 if @p write or
+	 * @p desc is NULL.
+	 */
+	extern int fmt_cbprintf(fmt_sink_t write, void *ctx, const fmt_desc_t *desc, ...);
+
+	/**
+	 * @brief Formats arguments with a format descriptor into a string.
+	 *
+	 * @param str  Output string (may be NULL if @p size is zero).
+	 * @param size Write at most size bytes (including null byte).
+	 * @param desc Format descriptor.
+	 *
+	 * @returns Length of the untruncated output string, or -1 if @p desc
+	 * is NULL.
+	 */
+	extern int fmt_snprintf(char *str, size_t size, const fmt_desc_t *desc, ...);
+
+/**@}*/
+
+/*============================================================================*
+ * Binary Logging                                                             *
+ *============================================================================*/
+
+/**
+ * @addtogroup barelib-binlog Binary Logging
+ * @ingroup barelib
+ *
+ * @details A binary log defers formatting out of the hot path. Call
+ * sites record only the address of a format descriptor, compiled once
+ * with fmt_compile(), a timestamp and raw argument words into a
+ * preallocated ring, and the records are formatted later, when the log
+ * is drained. A log is not synchronized:
+ * use one log per core, and do not drain it while records are added.
+ */
+/**@{*/
+
+	/**
+	 * @brief Maximum number of arguments in a binary log record.
+	 */
+	#define BINLOG_MAX_ARGS 6
+
+	/**
+	 * @brief Binary log record.
+	 */
+	typedef struct
+	{
+		const fmt_desc_t *desc;         /**< Format descriptor.   */
+		uint64_t timestamp;             /**< Timestamp.           */
+		unsigned nargs;                 /**< Number of arguments. */
+		uint64_t args[BINLOG_MAX_ARGS]; /**< Raw argument words.  */
+	} binlog_record_t;
+
+	/**
+	 * @brief Binary log.
+	 */
+	typedef struct
+	{
+		binlog_record_t *records; /**< Ring of records.            */
+		size_t nrecords;          /**< Number of records in ring.  */
+		size_t head;              /**< Next record to drain.       */
+		size_t tail;              /**< Next record to fill.        */
+		size_t dropped;           /**< Records dropped when full.  */
+		uint64_t (*clock)(void);  /**< Timestamp source.           */
+	} binlog_t;
+
+	/**
+	 * @brief Initializes a binary log.
+	 *
+	 * @param log      Target binary log.
+	 * @param records  Preallocated ring of records.
+	 * @param nrecords Number of records in @p records (a power of two).
+	 * @param clock    Timestamp source (may be NULL).
+	 *
+	 * @returns Zero on success, and -1 if @p nrecords is not a power of
+	 * two.
+	 */
+	extern int binlog_init(binlog_t *log, binlog_record_t *records, size_t nrecords, uint64_t (*clock)(void));
+
+	/**
+	 * @brief Records a message in a binary log, without formatting it.
+	 *
+	 * @details Arguments are recorded as raw words, so the string of a
+	 * %s conversion is recorded by address and read only when the log is
+	 * drained: it must outlive the record. Logging a stack or temporary
+	 * buffer leaves a dangling pointer in the log.
+	 *
+	 * @param log  Target binary log.
+	 * @param desc Format descriptor (must outlive the record).
+	 *
+	 * @returns Zero if the message is recorded, and -1 if the log is
+	 * full and the message is dropped, or if the message takes more than
+	 * #BINLOG_MAX_ARGS arguments (counting * field widths and precisions)
+	 * and is rejected.
+	 */
+	extern int __binlog(binlog_t *log, const fmt_desc_t *desc, ...);
+
+	/**
+	 * @brief Formats all records of a binary log into an output sink.
+	 *
+	 * @param log   Target binary log.
+	 * @param write Output sink.
+	 * @param ctx   Context passed to @p write.
+	 *
+	 * @returns The number of drained records, or -1 if @p write is NULL.
+	 */
+	extern int binlog_drain(binlog_t *log, fmt_sink_t write, void *ctx);
+
+/**@}*/
+
+/*============================================================================*
+ * Log Rings                                                                  *
+ *============================================================================*/
+
+/**
+ * @addtogroup barelib-logring Log Rings
+ * @ingroup barelib
+ *
+ * @details A log ring is a fixed-size ring of formatted messages owned
+ * by a single core. The owner fills it without locking, and a reader
+ * merges the rings of all cores in timestamp order and flushes them.
+ */
+/**@{*/
+
+	/**
+	 * @brief Maximum length of a log ring message (including null byte).
+	 */
+	#define LOGRING_MSG_SIZE 116
+
+	/**
+	 * @brief Log ring record.
+	 */
+	typedef struct
+	{
+		uint64_t timestamp;         /**< Timestamp. */
+		char msg[LOGRING_MSG_SIZE]; /**< Message.   */
+	} logring_record_t;
+
+	/**
+	 * @brief Log ring.
+	 */
+	typedef struct
+	{
+		logring_record_t *records; /**< Ring of records.                 */
+		size_t nrecords;           /**< Number of records in ring.       */
+		size_t head;               /**< Next record to flush (reader).   */
+		size_t tail;               /**< Next record to fill (owner).     */
+		size_t limit;              /**< Flush limit (reader).            */
+		size_t dropped;            /**< Messages dropped when full.      */
+		uint64_t (*clock)(void);   /**< Timestamp source.                */
+	} logring_t;
+
+	/**
+	 * @brief Initializes a log ring.
+	 *
+	 * @param ring     Target log ring.
+	 * @param records  Preallocated ring of records.
+	 * @param nrecords Number of records in @p records (a power of two).
+	 * @param clock    Timestamp source (may be NULL).
+	 *
+	 * @returns Zero on success, and -1 if @p nrecords is not a power of
+	 * two.
+	 */
+	extern int logring_init(logring_t *ring, logring_record_t *records, size_t nrecords, uint64_t (*clock)(void));
+
+	/**
+	 * @brief Formats a message into a log ring.
+	 *
+	 * @param ring Target log ring (owned by the calling core).
+	 * @param fmt  Formatted string.
+	 *
+	 * @returns Zero if the message is recorded, and -1 if the ring is
+	 * full and the message is dropped.
+	 */
+	extern int logring_printf(logring_t *ring, const char *fmt, ...);
+
+	/**
+	 * @brief Merges log rings in timestamp order and flushes them.
+	 *
+	 * @param rings  Target log rings.
+	 * @param nrings Number of log rings in @p rings.
+	 * @param write  Output sink.
+	 * @param ctx    Context passed to @p write.
+	 *
+	 * @returns The number of flushed records, or -1 if @p write is NULL.
+	 */
+	extern int logring_flush(logring_t *rings, unsigned nrings, fmt_sink_t write, void *ctx);
+
+/**@}*/
+
 /*============================================================================*
  * Bitmap                                                                     *
  *============================================================================*/
@@ -343,7 +685,7 @@
 	 * @param pos	Position of the bit that shall be set.
 	 */
 	#define bitmap_set(bitmap, pos) \
-		(((bitmap_t *)(bitmap))[IDX(pos)] |= (0x1 << OFF(pos)))
+		(((bitmap_t *)(bitmap))[IDX(pos)] |= (0x1U << OFF(pos)))
 
 	/**
 	 * @brief Clears a bit in a bitmap.
@@ -352,13 +694,32 @@
 	 * @param pos	Position of the bit that shall be cleared.
 	 */
 	#define bitmap_clear(bitmap, pos) \
-		(((bitmap_t *)(bitmap))[IDX(pos)] &= ~(0x1 << OFF(pos)))
+		(((bitmap_t *)(bitmap))[IDX(pos)] &= ~(0x1U << OFF(pos)))
+
+	/**
+	 * @brief Tests a bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap where the bit should be tested.
+	 * @param pos	Position of the bit that shall be tested.
+	 */
+	#define bitmap_test(bitmap, pos) \
+		(((const bitmap_t *)(bitmap))[IDX(pos)] & (0x1U << OFF(pos)))
+
+	/**
+	 * @brief Number of bitmap words needed to hold a number of bits.
+	 *
+	 * @param nbits Number of bits.
+	 */
+	#define BITMAP_NWORDS(nbits) \
+		(((nbits) + BITMAP_WORD_LENGTH - 1) >> BITMAP_WORD_SHIFT)
 
 	/**
 	 * @brief Returns the number of bits that are set in a bitmap.
 	 *
-	 * @details Counts the number of bits that are set in a bitmap using a
-	 *		  bit-hacking algorithm from Stanford.
+	 * @details Counts the number of bits that are set in a bitmap, a long
+	 *		  word at a time, using the population count instruction of the
+	 *		  ISA or a bit-hacking algorithm from Stanford. Trailing bytes
+	 *		  that do not fill a bitmap word are counted as well.
 	 *
 	 * @param bitmap Bitmap to be searched.
 	 * @param size   Size (in bytes) of the bitmap.
@@ -370,8 +731,8 @@
 	/**
 	 * @brief Returns the number of bits that are cleared in a bitmap.
 	 *
-	 * @details Counts the number of bits that are cleared in a bitmap using a
-	 *		  bit-hacking algorithm from Stanford.
+	 * @details Counts the number of bits that are cleared in a bitmap (see
+	 *		  bitmap_nset()).
 	 *
 	 * @param bitmap Bitmap to be searched.
 	 * @param size   Size (in bytes) of the bitmap.
@@ -384,7 +745,8 @@
 	 * @brief Searches for the first free bit in a bitmap.
 	 *
 	 * @details Searches for the first free bit in a bitmap. In order to speedup
-	 *		  computation, bits are checked in chunks of 4 bytes.
+	 *		  computation, full words are skipped in blocks of long words,
+	 *		  and the free bit is located with a count-trailing-zeros.
 	 *
 	 * @param bitmap Bitmap to be searched.
 	 * @param size   Size (in bytes) of the bitmap.
@@ -406,6 +768,423 @@
 	 */
 	extern bitmap_t bitmap_check_bit(bitmap_t *, bitmap_t);
 
+	/**
+	 * @brief Searches for the next free bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap to be searched.
+	 * @param size   Size (in bytes) of the bitmap.
+	 * @param pos    Position where the search starts.
+	 *
+	 * @returns If a free bit is found at or after @p pos, the number of that
+	 *		  bit is returned. However, if no free bit is found #BITMAP_FULL
+	 *		  is returned instead.
+	 */
+	extern bitmap_t bitmap_find_next_zero(bitmap_t *, size_t, bitmap_t);
+
+	/**
+	 * @brief Searches for the next set bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap to be searched.
+	 * @param size   Size (in bytes) of the bitmap.
+	 * @param pos    Position where the search starts.
+	 *
+	 * @returns If a set bit is found at or after @p pos, the number of that
+	 *		  bit is returned. However, if no set bit is found #BITMAP_FULL
+	 *		  is returned instead.
+	 */
+	extern bitmap_t bitmap_find_next_set(bitmap_t *, size_t, bitmap_t);
+
+	/**
+	 * @brief Searches for the last set bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap to be searched.
+	 * @param size   Size (in bytes) of the bitmap.
+	 *
+	 * @returns If a set bit is found, the number of the last one is returned.
+	 *		  However, if no set bit is found #BITMAP_FULL is returned instead.
+	 */
+	extern bitmap_t bitmap_find_last_set(bitmap_t *, size_t);
+
+	/**
+	 * @brief Sets a range of bits in a bitmap.
+	 *
+	 * @param bitmap Bitmap where the bits should be set.
+	 * @param pos    Position of the first bit that shall be set.
+	 * @param n      Number of bits that shall be set.
+	 */
+	extern void bitmap_set_range(bitmap_t *, bitmap_t, size_t);
+
+	/**
+	 * @brief Clears a range of bits in a bitmap.
+	 *
+	 * @param bitmap Bitmap where the bits should be cleared.
+	 * @param pos    Position of the first bit that shall be cleared.
+	 * @param n      Number of bits that shall be cleared.
+	 */
+	extern void bitmap_clear_range(bitmap_t *, bitmap_t, size_t);
+
+	/**
+	 * @brief Searches for a run of free bits in a bitmap.
+	 *
+	 * @param bitmap      Bitmap to be searched.
+	 * @param size        Size (in bytes) of the bitmap.
+	 * @param n           Number of consecutive free bits.
+	 * @param align_shift The first bit of the run must be a multiple of
+	 *                    2^align_shift (zero for no alignment). It must be
+	 *                    less than #BITMAP_WORD_LENGTH.
+	 *
+	 * @returns If a run is found, the number of its first bit is returned.
+	 *		  However, if no run is found, or if @p n is zero or
+	 *		  @p align_shift is out of range, #BITMAP_FULL is returned
+	 *		  instead.
+	 */
+	extern bitmap_t bitmap_find_run(bitmap_t *, size_t, size_t, unsigned);
+
+	/*
+	 * The atomic bitmap operations are provided only on targets with
+	 * native 32-bit atomics. Elsewhere, they are not declared, so that
+	 * callers fail to build instead of silently racing.
+	 */
+	#if (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+
+	/**
+	 * @brief Atomically sets a bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap where the bit should be set.
+	 * @param pos    Position of the bit that shall be set.
+	 *
+	 * @returns The previous value of the bit (zero or one).
+	 */
+	extern int bitmap_test_and_set(bitmap_t *, bitmap_t);
+
+	/**
+	 * @brief Atomically clears a bit in a bitmap.
+	 *
+	 * @param bitmap Bitmap where the bit should be cleared.
+	 * @param pos    Position of the bit that shall be cleared.
+	 *
+	 * @returns The previous value of the bit (zero or one).
+	 */
+	extern int bitmap_test_and_clear(bitmap_t *, bitmap_t);
+
+	/**
+	 * @brief Atomically claims the first free bit in a bitmap.
+	 *
+	 * @details Several cores may claim bits from the same bitmap
+	 *		  concurrently, without a lock, provided that they only update
+	 *		  it with the atomic bitmap operations.
+	 *
+	 * @param bitmap Bitmap to be searched.
+	 * @param size   Size (in bytes) of the bitmap.
+	 *
+	 * @returns If a free bit is claimed, the number of that bit is returned.
+	 *		  However, if no free bit is found #BITMAP_FULL is returned instead.
+	 */
+	extern bitmap_t bitmap_claim_first_free(bitmap_t *, size_t);
+
+	#endif
+
+	/**
+	 * @brief Next-fit bitmap allocator.
+	 *
+	 * @details Hands out free bits of a bitmap in order, searching from
+	 *		  the bit that follows the last allocated one and wrapping
+	 *		  around the end of the bitmap.
+	 */
+	typedef struct
+	{
+		bitmap_t *bitmap; /**< Underlying bitmap.             */
+		size_t size;      /**< Size (in bytes) of the bitmap. */
+		bitmap_t cursor;  /**< Where the next search starts.  */
+	} bitmap_nextfit_t;
+
+	/**
+	 * @brief Initializes a next-fit bitmap allocator.
+	 *
+	 * @param nf     Target allocator.
+	 * @param bitmap Underlying bitmap.
+	 * @param size   Size (in bytes) of the bitmap.
+	 */
+	extern void bitmap_nextfit_init(bitmap_nextfit_t *, bitmap_t *, size_t);
+
+	/**
+	 * @brief Allocates a bit with a next-fit bitmap allocator.
+	 *
+	 * @param nf Target allocator.
+	 *
+	 * @returns The number of the allocated bit. However, if no free bit is
+	 *		  found #BITMAP_FULL is returned instead.
+	 */
+	extern bitmap_t bitmap_nextfit_alloc(bitmap_nextfit_t *);
+
+	/**
+	 * @brief Releases a bit of a next-fit bitmap allocator.
+	 *
+	 * @param nf  Target allocator.
+	 * @param pos Number of the bit to be released.
+	 */
+	extern void bitmap_nextfit_free(bitmap_nextfit_t *, bitmap_t);
+
+/**@}*/
+
+/*============================================================================*
+ * Hierarchical Bitmap                                                        *
+ *============================================================================*/
+
+/**
+ * @addtogroup barelib-hbitmap Hierarchical Bitmap
+ * @ingroup barelib
+ *
+ * @details A hierarchical bitmap stacks summary levels on top of a flat
+ * bitmap. Each bit of a summary level is set if and only if the
+ * corresponding word of the level below is full, and the topmost level
+ * is a single word. The first free bit is thus found with one word load
+ * per level, regardless of how full the bitmap is.
+ */
+/**@{*/
+
+	/**
+	 * @brief Maximum number of levels in a hierarchical bitmap.
+	 */
+	#define HBITMAP_MAX_LEVELS 6
+
+	/**
+	 * @brief Hierarchical bitmap.
+	 */
+	typedef struct
+	{
+		size_t nbits;                          /**< Number of bits.            */
+		unsigned nlevels;                      /**< Number of levels.          */
+		bitmap_t *levels[HBITMAP_MAX_LEVELS];  /**< Levels, leaf level first.  */
+	} hbitmap_t;
+
+	/**
+	 * @brief Returns the storage size of a hierarchical bitmap.
+	 *
+	 * @param nbits Number of bits in the bitmap.
+	 *
+	 * @returns The size (in bytes) of the storage needed by a
+	 * hierarchical bitmap of @p nbits bits, summary levels included.
+	 */
+	extern size_t hbitmap_size(size_t nbits);
+
+	/**
+	 * @brief Initializes a hierarchical bitmap, with all bits cleared.
+	 *
+	 * @param hb      Target hierarchical bitmap.
+	 * @param storage Storage of the bitmap (see hbitmap_size()).
+	 * @param nbits   Number of bits in the bitmap.
+	 *
+	 * @returns Zero on success, and -1 if @p nbits is zero or it needs
+	 * more than #HBITMAP_MAX_LEVELS levels.
+	 */
+	extern int hbitmap_init(hbitmap_t *hb, bitmap_t *storage, size_t nbits);
+
+	/**
+	 * @brief Sets a bit in a hierarchical bitmap.
+	 *
+	 * @param hb  Target hierarchical bitmap.
+	 * @param pos Position of the bit that shall be set.
+	 */
+	extern void hbitmap_set(hbitmap_t *hb, bitmap_t pos);
+
+	/**
+	 * @brief Clears a bit in a hierarchical bitmap.
+	 *
+	 * @param hb  Target hierarchical bitmap.
+	 * @param pos Position of the bit that shall be cleared.
+	 */
+	extern void hbitmap_clear(hbitmap_t *hb, bitmap_t pos);
+
+	/**
+	 * @brief Checks what is the value of the nth bit of a hierarchical bitmap.
+	 *
+	 * @param hb  Target hierarchical bitmap.
+	 * @param pos Position of the bit to be checked.
+	 *
+	 * @returns The value of the bit in the @p pos position.
+	 */
+	extern bitmap_t hbitmap_check_bit(const hbitmap_t *hb, bitmap_t pos);
+
+	/**
+	 * @brief Searches for the first free bit in a hierarchical bitmap.
+	 *
+	 * @param hb Target hierarchical bitmap.
+	 *
+	 * @returns If a free bit is found, the number of that bit is returned. However,
+	 *		  if no free bit is found #BITMAP_FULL is returned instead.
+	 */
+	extern bitmap_t hbitmap_first_free(const hbitmap_t *hb);
+
+/**@}*/
+
+/*============================================================================*
+ * Division by Invariant Integers                                             *
+ *============================================================================*/
+
+/**
+ * @addtogroup barelib-divider Division by Invariant Integers
+ * @ingroup barelib
+ *
+ * @details A divider holds a precomputed reciprocal of a divisor, so
+ * that dividing by it takes a multiply-high and a shift, instead of a
+ * full division. Dividers pay off when the same runtime divisor is used
+ * many times.
+ */
+/**@{*/
+
+	/**
+	 * @brief Divider for 32-bit unsigned integers.
+	 */
+	typedef struct
+	{
+		uint32_t magic;    /**< Magic number.            */
+		uint32_t divisor;  /**< Divisor.                 */
+		uint8_t  more;     /**< Shift amount and flags.  */
+	} divu32_t;
+
+	/**
+	 * @brief Divider for 32-bit signed integers.
+	 */
+	typedef struct
+	{
+		int32_t magic;    /**< Magic number.            */
+		int32_t divisor;  /**< Divisor.                 */
+		uint8_t more;     /**< Shift amount and flags.  */
+	} divs32_t;
+
+	/**
+	 * @brief Divider for 64-bit unsigned integers.
+	 */
+	typedef struct
+	{
+		uint64_t magic;    /**< Magic number.            */
+		uint64_t divisor;  /**< Divisor.                 */
+		uint8_t  more;     /**< Shift amount and flags.  */
+	} divu64_t;
+
+	/**
+	 * @brief Divider for 64-bit signed integers.
+	 */
+	typedef struct
+	{
+		int64_t magic;    /**< Magic number.            */
+		int64_t divisor;  /**< Divisor.                 */
+		uint8_t more;     /**< Shift amount and flags.  */
+	} divs64_t;
+
+	/**
+	 * @brief Initializes a divider for 32-bit unsigned integers.
+	 *
+	 * @param div     Target divider.
+	 * @param divisor Divisor (must be non-zero).
+	 */
+	extern void divu32_init(divu32_t *div, uint32_t divisor);
+
+	/**
+	 * @brief Divides a 32-bit unsigned integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n divided by the divisor of @p div.
+	 */
+	extern uint32_t divu32_div(const divu32_t *div, uint32_t n);
+
+	/**
+	 * @brief Module of a 32-bit unsigned integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n module by the divisor of @p div.
+	 */
+	extern uint32_t divu32_mod(const divu32_t *div, uint32_t n);
+
+	/**
+	 * @brief Initializes a divider for 32-bit signed integers.
+	 *
+	 * @param div     Target divider.
+	 * @param divisor Divisor (must be non-zero).
+	 */
+	extern void divs32_init(divs32_t *div, int32_t divisor);
+
+	/**
+	 * @brief Divides a 32-bit signed integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n divided by the divisor of @p div.
+	 */
+	extern int32_t divs32_div(const divs32_t *div, int32_t n);
+
+	/**
+	 * @brief Module of a 32-bit signed integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n module by the divisor of @p div.
+	 */
+	extern int32_t divs32_mod(const divs32_t *div, int32_t n);
+
+	/**
+	 * @brief Initializes a divider for 64-bit unsigned integers.
+	 *
+	 * @param div     Target divider.
+	 * @param divisor Divisor (must be non-zero).
+	 */
+	extern void divu64_init(divu64_t *div, uint64_t divisor);
+
+	/**
+	 * @brief Divides a 64-bit unsigned integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n divided by the divisor of @p div.
+	 */
+	extern uint64_t divu64_div(const divu64_t *div, uint64_t n);
+
+	/**
+	 * @brief Module of a 64-bit unsigned integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n module by the divisor of @p div.
+	 */
+	extern uint64_t divu64_mod(const divu64_t *div, uint64_t n);
+
+	/**
+	 * @brief Initializes a divider for 64-bit signed integers.
+	 *
+	 * @param div     Target divider.
+	 * @param divisor Divisor (must be non-zero).
+	 */
+	extern void divs64_init(divs64_t *div, int64_t divisor);
+
+	/**
+	 * @brief Divides a 64-bit signed integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n divided by the divisor of @p div.
+	 */
+	extern int64_t divs64_div(const divs64_t *div, int64_t n);
+
+	/**
+	 * @brief Module of a 64-bit signed integer using a divider.
+	 *
+	 * @param div Divider.
+	 * @param n   Dividend.
+	 *
+	 * @returns The result of @p n module by the divisor of @p div.
+	 */
+	extern int64_t divs64_mod(const divs64_t *div, int64_t n);
+
 /**@}*/
 
 /*============================================================================*
@@ -424,7 +1203,8 @@
 	 * @param a First operand.
 	 * @param b Second operand.
 	 *
-	 * @returns The result of @p a divided by @p b.
+	 * @returns The result of @p a divided by @p b, truncated towards
+	 * zero.
 	 */
 	extern int __div(int a, int b);
 
@@ -518,6 +1298,111 @@
 	 */
 	extern unsigned long __udivmodsi4(unsigned long num, unsigned long den, int modwanted);
 
+	/**
+	 * @brief Divides two unsigned long long integers.
+	 *
+	 * @param num Dividend.
+	 * @param den Divisor.
+	 * @param rem Location to store the remainder (may be NULL).
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The result of @p num divided by @p den.
+	 */
+	extern unsigned long long __udivmoddi4(unsigned long long num, unsigned long long den, unsigned long long *rem);
+
+	/**
+	 * @brief Divides two long long integers.
+	 *
+	 * @param a First operand.
+	 * @param b Second operand.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The result of @p a divided by @p b.
+	 */
+	extern long long __divdi3(long long a, long long b);
+
+	/**
+	 * @brief Module between two long long integers.
+	 *
+	 * @param a First operand.
+	 * @param b Second operand.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The result of @p a module by @p b.
+	 */
+	extern long long __moddi3(long long a, long long b);
+
+	/**
+	 * @brief Divides two unsigned long long integers.
+	 *
+	 * @param a First operand.
+	 * @param b Second operand.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The result of @p a divided by @p b.
+	 */
+	extern unsigned long long __udivdi3(unsigned long long a, unsigned long long b);
+
+	/**
+	 * @brief Module between two unsigned long long integers.
+	 *
+	 * @param a First operand.
+	 * @param b Second operand.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The result of @p a module by @p b.
+	 */
+	extern unsigned long long __umoddi3(unsigned long long a, unsigned long long b);
+
+	/**
+	 * @brief Counts leading zeros of an unsigned integer.
+	 *
+	 * @param a Target integer.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The number of leading zero bits in @p a.
+	 */
+	extern int __clzsi2(unsigned a);
+
+	/**
+	 * @brief Counts leading zeros of an unsigned long long integer.
+	 *
+	 * @param a Target integer.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The number of leading zero bits in @p a.
+	 */
+	extern int __clzdi2(unsigned long long a);
+
+	/**
+	 * @brief Counts trailing zeros of an unsigned integer.
+	 *
+	 * @param a Target integer.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The number of trailing zero bits in @p a.
+	 */
+	extern int __ctzsi2(unsigned a);
+
+	/**
+	 * @brief Counts trailing zeros of an unsigned long long integer.
+	 *
+	 * @param a Target integer.
+	 *
+	 * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+	 *
+	 * @returns The number of trailing zero bits in @p a.
+	 */
+	extern int __ctzdi2(unsigned long long a);
+
 /**@}*/
 
 #endif /* NANVIX_BARELIB_H_ */
@@ -26,43 +26,123 @@
 #include <posix/stddef.h>
 #include <posix/stdint.h>
 
+#if defined(__unix64__) && defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+
+/* Nonzero if X is not aligned on a "long" boundary.  */
+#define UNALIGNED(X) ((long)X & (LBLOCKSIZE - 1))
+
+/* How many bytes are counted each iteration of the word loop.  */
+#define LBLOCKSIZE (sizeof (long))
+
+/* How many bytes are scanned each iteration of the vector loop.  */
+#define WIDEBLOCKSIZE 64
+
+/* Long word X, with the bits of its bitmap words in ascending order.  */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) && \
+	(__SIZEOF_LONG__ > 4)
+#define WORDORDER(X) (((X) << 32) | ((X) >> 32))
+#else
+#define WORDORDER(X) (X)
+#endif
+
+/* How many long words are counted each iteration of the block loop.  */
+#define CSABLOCKSIZE 8
+
+/* Carry-save adder: adds A, B and C into a high (H) and a low (L) word.  */
+#define CSA(H, L, A, B, C)               \
+	do                                   \
+	{                                    \
+		unsigned long u = (A) ^ (B);     \
+		(H) = ((A) & (B)) | (u & (C));   \
+		(L) = u ^ (C);                   \
+	} while (0)
+
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Counts the number of bits set in a long word.
+ *
+ * @details Uses the population count instruction of the ISA, if there
+ * is one, and a bit-hacking algorithm from Stanford otherwise.
+ *
+ * @param x Target long word.
+ *
+ * @returns The number of bits set in @p x.
+ */
+static inline unsigned popcount(unsigned long x)
+{
+#if defined(__POPCNT__) || defined(__riscv_zbb)
+	return (__builtin_popcountl(x));
+#else
+	x = x - ((x >> 1) & (~0UL/3));
+	x = (x & (~0UL/15*3)) + ((x >> 2) & (~0UL/15*3));
+	x = (x + (x >> 4)) & (~0UL/255*15);
+	return ((unsigned)((x * (~0UL/255)) >> ((sizeof(long) - 1)*8)));
+#endif
+}
+
+/**
+ * The bitmap_nset() function counts the number of bits that are set in
+ * the first @p size bytes of the bitmap pointed to by @p bitmap.
+ *
+ * Bits are counted a long word at a time. Large bitmaps are counted in
+ * blocks of #CSABLOCKSIZE long words, which are first reduced with a
+ * tree of carry-save adders (Harley-Seal), so that a single population
+ * count is needed per block.
  */
 bitmap_t bitmap_nset(bitmap_t *bitmap, size_t size)
 {
-	bitmap_t count; /* Number of bits set. */
-	bitmap_t *idx;  /* Loop index.         */
-	bitmap_t *end;  /* End of bitmap.      */
-	bitmap_t chunk; /* Working chunk.      */
+	size_t count = 0;               /* Number of bits set. */
+	const unsigned char *p;         /* Working byte.       */
+	const unsigned long *aligned_p; /* Working long word.  */
+
+	p = (const unsigned char *)bitmap;
 
-	/**
-	 * @brief Assert bitmap size.
-	 */
-	((void) sizeof(char[(((sizeof(bitmap_t)) == (BITMAP_WORD_LENGTH/8)) ? 1 : -1)]));
+	/* Count bytes until aligned. */
+	for (/* noop */; size > 0 && UNALIGNED(p); size--)
+		count += popcount(*p++);
 
-	/* Count the number of bits set. */
-	count = 0;
-	end = (bitmap + (size >> 2));
-	for (idx = bitmap; idx < end; idx++)
+	aligned_p = (const unsigned long *)p;
+
+	/* Count blocks of long words. */
+	if (size >= CSABLOCKSIZE*LBLOCKSIZE)
 	{
-		chunk = *idx;
-
-		/*
-		 * Fast way for counting number of bits set in a bit map.
-		 * I have no idea how does it work. I just got it from here:
-		 * https://graphics.stanford.edu/~seander/bithacks.html
-		 */
-		chunk = chunk - ((chunk >> 1) & 0x55555555);
-		chunk = (chunk & 0x33333333) + ((chunk >> 2) & 0x33333333);
-		count += (((chunk + (chunk >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+		unsigned long ones = 0, twos = 0, fours = 0, eights = 0;
+		unsigned long twos_a, twos_b, fours_a, fours_b;
+		size_t eights_count = 0;
+
+		for (/* noop */; size >= CSABLOCKSIZE*LBLOCKSIZE; size -= CSABLOCKSIZE*LBLOCKSIZE)
+		{
+			CSA(twos_a, ones, ones, aligned_p[0], aligned_p[1]);
+			CSA(twos_b, ones, ones, aligned_p[2], aligned_p[3]);
+			CSA(fours_a, twos, twos, twos_a, twos_b);
+			CSA(twos_a, ones, ones, aligned_p[4], aligned_p[5]);
+			CSA(twos_b, ones, ones, aligned_p[6], aligned_p[7]);
+			CSA(fours_b, twos, twos, twos_a, twos_b);
+			CSA(eights, fours, fours, fours_a, fours_b);
+
+			eights_count += popcount(eights);
+			aligned_p += CSABLOCKSIZE;
+		}
+
+		count += 8*eights_count + 4*popcount(fours) + 2*popcount(twos) + popcount(ones);
 	}
 
-	return (count);
+	/* Count long words. */
+	for (/* noop */; size >= LBLOCKSIZE; size -= LBLOCKSIZE)
+		count += popcount(*aligned_p++);
+
+	/* Count remaining bytes. */
+	for (p = (const unsigned char *)aligned_p; size > 0; size--)
+		count += popcount(*p++);
+
+	return ((bitmap_t)count);
 }
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * The bitmap_nclear() function counts the number of bits that are
+ * cleared in the first @p size bytes of the bitmap pointed to by
+ * @p bitmap.
  */
 bitmap_t bitmap_nclear(bitmap_t *bitmap, size_t size)
 {
@@ -70,33 +150,78 @@ bitmap_t bitmap_nclear(bitmap_t *bitmap, size_t size)
 }
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * The bitmap_first_free() function searches for the first bit that is
+ * cleared in the first @p size bytes of the bitmap pointed to by
+ * @p bitmap.
+ *
+ * Full words are skipped in blocks of long words (SSE2 vectors on
+ * x86-64), and the first cleared bit of a word that is not full is
+ * located with a count-trailing-zeros of the inverted word.
  */
 bitmap_t bitmap_first_free(bitmap_t *bitmap, size_t size)
 {
-    bitmap_t *max;          /* Bitmap bondary. */
-    register bitmap_t off;  /* Bit offset.     */
-    register bitmap_t *idx; /* Bit index.      */
+	const bitmap_t *idx;              /* Working word.        */
+	const bitmap_t *max;              /* Bitmap boundary.     */
+	const unsigned long *aligned_idx; /* Working long word.   */
+	size_t nlongs;                    /* Long words left.     */
+	unsigned long word;               /* Inverted long word.  */
 
-    idx = bitmap;
-    max = (idx + (size >> 2));
+	idx = bitmap;
+	max = (idx + (size >> 2));
 
-    /* Find bit index. */
-    while (idx < max)
-    {
-		/* Index found. */
-		if (*idx != 0xffffffff)
-		{
-			off = 0;
+	/* Check words until aligned. */
+	for (/* noop */; idx < max && UNALIGNED(idx); idx++)
+	{
+		if (*idx != BITMAP_FULL)
+			return (((idx - bitmap) << BITMAP_WORD_SHIFT) + __builtin_ctz(~*idx));
+	}
+
+	aligned_idx = (const unsigned long *)idx;
+	nlongs = (size_t)(max - idx)/(LBLOCKSIZE/sizeof(bitmap_t));
+
+#if defined(__unix64__) && defined(__x86_64__)
+
+	/* Skip blocks of full long words, a vector at a time. */
+	for (/* noop */; nlongs >= WIDEBLOCKSIZE/LBLOCKSIZE; nlongs -= WIDEBLOCKSIZE/LBLOCKSIZE)
+	{
+		const __m128i *v = (const __m128i *)aligned_idx;
+		__m128i x;
 
-			/* Find offset. */
-			while (*idx & (0x1 << off))
-				off++;
+		x = _mm_and_si128(
+			_mm_and_si128(_mm_loadu_si128(v), _mm_loadu_si128(v + 1)),
+			_mm_and_si128(_mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3))
+		);
 
-			return (((idx - bitmap) << BITMAP_WORD_SHIFT) + off);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(x, _mm_set1_epi32(-1))) != 0xffff)
+			break;
+
+		aligned_idx += WIDEBLOCKSIZE/LBLOCKSIZE;
+	}
+
+#endif
+
+	/* Skip blocks of full long words. */
+	for (/* noop */; nlongs >= 4; nlongs -= 4, aligned_idx += 4)
+	{
+		if ((aligned_idx[0] & aligned_idx[1] & aligned_idx[2] & aligned_idx[3]) != ~0UL)
+			break;
+	}
+
+	/* Check long words. */
+	for (/* noop */; nlongs > 0; nlongs--, aligned_idx++)
+	{
+		if ((word = ~*aligned_idx) != 0)
+		{
+			idx = (const bitmap_t *)aligned_idx;
+			return (((idx - bitmap) << BITMAP_WORD_SHIFT) + __builtin_ctzl(WORDORDER(word)));
 		}
+	}
 
-		idx++;
+	/* Check remaining words. */
+	for (idx = (const bitmap_t *)aligned_idx; idx < max; idx++)
+	{
+		if (*idx != BITMAP_FULL)
+			return (((idx - bitmap) << BITMAP_WORD_SHIFT) + __builtin_ctz(~*idx));
 	}
 
 	return (BITMAP_FULL);
@@ -109,3 +234,348 @@ bitmap_t bitmap_check_bit(bitmap_t *bitmap, bitmap_t idx)
 {
 	return (bitmap[IDX(idx)] & (1 << OFF(idx)));
 }
+
+/**
+ * The bitmap_find_next_zero() function searches for the first bit that
+ * is cleared in the first @p size bytes of the bitmap pointed to by
+ * @p bitmap, starting at bit @p pos. Bits below @p pos in its word are
+ * masked as set, and the remaining words are handed to
+ * bitmap_first_free().
+ */
+bitmap_t bitmap_find_next_zero(bitmap_t *bitmap, size_t size, bitmap_t pos)
+{
+	bitmap_t word;      /* Working word.  */
+	bitmap_t off;       /* Bit offset.    */
+	size_t nwords;      /* Bitmap words.  */
+
+	nwords = size >> 2;
+
+	/* Out of bounds. */
+	if (IDX(pos) >= nwords)
+		return (BITMAP_FULL);
+
+	/* Check first word. */
+	word = bitmap[IDX(pos)] | ((0x1U << OFF(pos)) - 1);
+	if (word != BITMAP_FULL)
+		return ((IDX(pos) << BITMAP_WORD_SHIFT) + __builtin_ctz(~word));
+
+	/* Search remaining words. */
+	off = bitmap_first_free(&bitmap[IDX(pos) + 1], (nwords - IDX(pos) - 1) << 2);
+	if (off == BITMAP_FULL)
+		return (BITMAP_FULL);
+
+	return (((IDX(pos) + 1) << BITMAP_WORD_SHIFT) + off);
+}
+
+/**
+ * The bitmap_find_next_set() function searches for the first bit that
+ * is set in the first @p size bytes of the bitmap pointed to by
+ * @p bitmap, starting at bit @p pos.
+ */
+bitmap_t bitmap_find_next_set(bitmap_t *bitmap, size_t size, bitmap_t pos)
+{
+	bitmap_t word;      /* Working word.  */
+	size_t idx;         /* Word index.    */
+	size_t nwords;      /* Bitmap words.  */
+
+	nwords = size >> 2;
+
+	/* Out of bounds. */
+	if (IDX(pos) >= nwords)
+		return (BITMAP_FULL);
+
+	/* Check first word. */
+	word = bitmap[IDX(pos)] & ~((0x1U << OFF(pos)) - 1);
+
+	/* Skip cleared words. */
+	for (idx = IDX(pos); word == 0; word = bitmap[idx])
+	{
+		if (++idx >= nwords)
+			return (BITMAP_FULL);
+	}
+
+	return ((idx << BITMAP_WORD_SHIFT) + __builtin_ctz(word));
+}
+
+/**
+ * The bitmap_find_last_set() function searches for the last bit that
+ * is set in the first @p size bytes of the bitmap pointed to by
+ * @p bitmap.
+ */
+bitmap_t bitmap_find_last_set(bitmap_t *bitmap, size_t size)
+{
+	size_t idx; /* Word index. */
+
+	/* Skip cleared words. */
+	for (idx = size >> 2; idx-- > 0; /* noop */)
+	{
+		if (bitmap[idx] != 0)
+			return ((idx << BITMAP_WORD_SHIFT) + (BITMAP_WORD_LENGTH - 1) - __builtin_clz(bitmap[idx]));
+	}
+
+	return (BITMAP_FULL);
+}
+
+/**
+ * The bitmap_set_range() function sets the @p n bits of the bitmap
+ * pointed to by @p bitmap that start at bit @p pos, a word at a time.
+ */
+void bitmap_set_range(bitmap_t *bitmap, bitmap_t pos, size_t n)
+{
+	bitmap_t *p = &bitmap[IDX(pos)];
+
+	if (n == 0)
+		return;
+
+	/* Range fits in a single word. */
+	if ((OFF(pos) + n) < BITMAP_WORD_LENGTH)
+	{
+		*p |= ((0x1U << n) - 1) << OFF(pos);
+		return;
+	}
+
+	/* Head word. */
+	*p++ |= BITMAP_FULL << OFF(pos);
+	n -= BITMAP_WORD_LENGTH - OFF(pos);
+
+	/* Full words. */
+	for (/* noop */; n >= BITMAP_WORD_LENGTH; n -= BITMAP_WORD_LENGTH)
+		*p++ = BITMAP_FULL;
+
+	/* Tail word. */
+	if (n > 0)
+		*p |= (0x1U << n) - 1;
+}
+
+/**
+ * The bitmap_clear_range() function clears the @p n bits of the bitmap
+ * pointed to by @p bitmap that start at bit @p pos, a word at a time.
+ */
+void bitmap_clear_range(bitmap_t *bitmap, bitmap_t pos, size_t n)
+{
+	bitmap_t *p = &bitmap[IDX(pos)];
+
+	if (n == 0)
+		return;
+
+	/* Range fits in a single word. */
+	if ((OFF(pos) + n) < BITMAP_WORD_LENGTH)
+	{
+		*p &= ~(((0x1U << n) - 1) << OFF(pos));
+		return;
+	}
+
+	/* Head word. */
+	*p++ &= ~(BITMAP_FULL << OFF(pos));
+	n -= BITMAP_WORD_LENGTH - OFF(pos);
+
+	/* Full words. */
+	for (/* noop */; n >= BITMAP_WORD_LENGTH; n -= BITMAP_WORD_LENGTH)
+		*p++ = 0;
+
+	/* Tail word. */
+	if (n > 0)
+		*p &= ~((0x1U << n) - 1);
+}
+
+/**
+ * @brief Searches for the first set bit in a range of a bitmap.
+ *
+ * @param bitmap Bitmap to be searched.
+ * @param pos    First bit of the range.
+ * @param end    Bit past the end of the range.
+ *
+ * @returns The number of the first set bit in [@p pos, @p end), or
+ * @p end if there is none.
+ */
+static size_t bitmap_find_set_until(const bitmap_t *bitmap, size_t pos, size_t end)
+{
+	size_t idx;    /* Word index.   */
+	bitmap_t word; /* Working word. */
+
+	idx = IDX(pos);
+	word = bitmap[idx] & ~((0x1U << OFF(pos)) - 1);
+
+	/* Skip cleared words. */
+	while (word == 0)
+	{
+		if ((++idx << BITMAP_WORD_SHIFT) >= end)
+			return (end);
+
+		word = bitmap[idx];
+	}
+
+	pos = (idx << BITMAP_WORD_SHIFT) + __builtin_ctz(word);
+
+	return ((pos < end) ? pos : end);
+}
+
+/**
+ * The bitmap_find_run() function searches for the first run of @p n
+ * consecutive cleared bits in the first @p size bytes of the bitmap
+ * pointed to by @p bitmap, whose first bit is a multiple of
+ * 2^@p align_shift.
+ *
+ * Candidate starts are found with bitmap_find_next_zero(), which skips
+ * full words. Each candidate is then measured up to @p n bits only,
+ * skipping cleared words, and the search resumes past the set bit that
+ * cut the run short.
+ */
+bitmap_t bitmap_find_run(bitmap_t *bitmap, size_t size, size_t n, unsigned align_shift)
+{
+	size_t nbits;  /* Bits in bitmap.          */
+	size_t mask;   /* Alignment mask.          */
+	size_t start;  /* Start of candidate run.  */
+	size_t end;    /* End of candidate run.    */
+	bitmap_t pos;  /* Where the search resumes. */
+
+	if ((n == 0) || (align_shift >= BITMAP_WORD_LENGTH))
+		return (BITMAP_FULL);
+
+	nbits = (size >> 2) << BITMAP_WORD_SHIFT;
+	mask = ((size_t)1 << align_shift) - 1;
+
+	for (pos = 0; /* noop */; pos = end)
+	{
+		pos = bitmap_find_next_zero(bitmap, size, pos);
+		if (pos == BITMAP_FULL)
+			return (BITMAP_FULL);
+
+		start = (pos + mask) & ~mask;
+		if ((start >= nbits) || (n > (nbits - start)))
+			return (BITMAP_FULL);
+
+		end = bitmap_find_set_until(bitmap, start, start + n);
+		if ((end - start) == n)
+			return (start);
+	}
+}
+
+/**
+ * The bitmap_nextfit_init() function initializes the next-fit allocator
+ * pointed to by @p nf, on top of the first @p size bytes of the bitmap
+ * pointed to by @p bitmap. The bitmap itself is left untouched.
+ */
+void bitmap_nextfit_init(bitmap_nextfit_t *nf, bitmap_t *bitmap, size_t size)
+{
+	nf->bitmap = bitmap;
+	nf->size = size;
+	nf->cursor = 0;
+}
+
+/**
+ * The bitmap_nextfit_alloc() function sets and returns the first bit
+ * that is cleared in the bitmap of the next-fit allocator pointed to by
+ * @p nf, searching from the bit that follows the last allocated one
+ * and wrapping around the end of the bitmap. Allocators that hand out
+ * bits in order thus do not rescan the bits they have already handed
+ * out.
+ */
+bitmap_t bitmap_nextfit_alloc(bitmap_nextfit_t *nf)
+{
+	bitmap_t pos;
+
+	/* Search from cursor, then wrap around. */
+	pos = bitmap_find_next_zero(nf->bitmap, nf->size, nf->cursor);
+	if ((pos == BITMAP_FULL) && (nf->cursor != 0))
+		pos = bitmap_find_next_zero(nf->bitmap, nf->size, 0);
+
+	if (pos == BITMAP_FULL)
+		return (BITMAP_FULL);
+
+	bitmap_set(nf->bitmap, pos);
+	nf->cursor = pos + 1;
+
+	return (pos);
+}
+
+/**
+ * The bitmap_nextfit_free() function clears the bit @p pos in the
+ * bitmap of the next-fit allocator pointed to by @p nf.
+ */
+void bitmap_nextfit_free(bitmap_nextfit_t *nf, bitmap_t pos)
+{
+	bitmap_clear(nf->bitmap, pos);
+}
+
+/*
+ * The atomic operations below rely on native 32-bit atomics. Without
+ * them, the compiler would emit calls into libatomic, which is not
+ * linked with barelib, and no lock built on the __atomic builtins would
+ * be atomic either, so the operations are not provided at all.
+ */
+#if (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+
+/**
+ * The bitmap_test_and_set() function atomically sets the bit @p pos of
+ * the bitmap pointed to by @p bitmap, and returns its previous value.
+ * Concurrent callers on the same bit see exactly one of them find it
+ * cleared.
+ */
+int bitmap_test_and_set(bitmap_t *bitmap, bitmap_t pos)
+{
+	bitmap_t mask = 0x1U << OFF(pos);
+
+	return ((__atomic_fetch_or(&bitmap[IDX(pos)], mask, __ATOMIC_ACQ_REL) & mask) != 0);
+}
+
+/**
+ * The bitmap_test_and_clear() function atomically clears the bit @p pos
+ * of the bitmap pointed to by @p bitmap, and returns its previous value.
+ */
+int bitmap_test_and_clear(bitmap_t *bitmap, bitmap_t pos)
+{
+	bitmap_t mask = 0x1U << OFF(pos);
+
+	return ((__atomic_fetch_and(&bitmap[IDX(pos)], ~mask, __ATOMIC_ACQ_REL) & mask) != 0);
+}
+
+/**
+ * The bitmap_claim_first_free() function atomically sets the first bit
+ * that is cleared in the first @p size bytes of the bitmap pointed to
+ * by @p bitmap, and returns its number. It is lock-free: the free bit
+ * of a word is claimed with a compare-and-swap, which on failure
+ * reloads the word and retries with its next free bit, and full words
+ * are skipped.
+ */
+bitmap_t bitmap_claim_first_free(bitmap_t *bitmap, size_t size)
+{
+	size_t idx;    /* Word index.   */
+	size_t nwords; /* Bitmap words. */
+	bitmap_t word; /* Working word. */
+
+	nwords = size >> 2;
+
+	for (idx = 0; idx < nwords; idx++)
+	{
+		/* Skip blocks of full words. */
+		for (/* noop */; (idx + 4) <= nwords; idx += 4)
+		{
+			word = __atomic_load_n(&bitmap[idx], __ATOMIC_RELAXED)
+				& __atomic_load_n(&bitmap[idx + 1], __ATOMIC_RELAXED)
+				& __atomic_load_n(&bitmap[idx + 2], __ATOMIC_RELAXED)
+				& __atomic_load_n(&bitmap[idx + 3], __ATOMIC_RELAXED);
+
+			if (word != BITMAP_FULL)
+				break;
+		}
+
+		if (idx >= nwords)
+			break;
+
+		word = __atomic_load_n(&bitmap[idx], __ATOMIC_RELAXED);
+
+		/* Claim a free bit, retrying if the word changes under us. */
+		while (word != BITMAP_FULL)
+		{
+			bitmap_t mask = ~word & (word + 1);
+
+			if (__atomic_compare_exchange_n(&bitmap[idx], &word, word | mask, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				return ((idx << BITMAP_WORD_SHIFT) + __builtin_ctz(mask));
+		}
+	}
+
+	return (BITMAP_FULL);
+}
+
+#endif
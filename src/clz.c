@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+
+/**
+ * @brief Counts leading zeros of an unsigned integer.
+ *
+ * @param a Target integer.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The number of leading zero bits in @p a, starting at the
+ * most significant bit.
+ *
+ * @note The compiler calls this function for __builtin_clz() on
+ * targets that lack a count-leading-zeros instruction.
+ */
+int __clzsi2(unsigned a)
+{
+	int n = 0;
+
+	if (a == 0)
+		return (32);
+
+	/* Binary search for the most significant bit. */
+	if (!(a & 0xffff0000)) { n += 16; a <<= 16; }
+	if (!(a & 0xff000000)) { n +=  8; a <<=  8; }
+	if (!(a & 0xf0000000)) { n +=  4; a <<=  4; }
+	if (!(a & 0xc0000000)) { n +=  2; a <<=  2; }
+	if (!(a & 0x80000000)) { n +=  1; }
+
+	return (n);
+}
+
+/**
+ * @brief Counts leading zeros of an unsigned long long integer.
+ *
+ * @param a Target integer.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The number of leading zero bits in @p a, starting at the
+ * most significant bit.
+ *
+ * @note The compiler calls this function for __builtin_clzll() on
+ * targets that lack a count-leading-zeros instruction.
+ */
+int __clzdi2(unsigned long long a)
+{
+	if (a >> 32)
+		return (__clzsi2((unsigned)(a >> 32)));
+
+	return (32 + __clzsi2((unsigned) a));
+}
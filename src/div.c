@@ -22,24 +22,32 @@
  * SOFTWARE.
  */
 
+#include <nanvix/barelib.h>
+
 /**
  * @brief Divides two integers.
  *
  * @param a First operand.
  * @param b Second operand.
  *
- * @returns The result of @p a divided by @p b.
+ * @returns The result of @p a divided by @p b, truncated towards zero.
  */
 int __div(int a, int b)
 {
-	int n = 0;
+#if (__HAS_HW_DIVISION)
 
-	while (a > b)
-	{
-		a -= b;
-		n++;
-	}
+	return (a / b);
 
-	return (n);
-}
+#else
+
+	unsigned ua = (a < 0) ? -(unsigned)a : (unsigned)a;
+	unsigned ub = (b < 0) ? -(unsigned)b : (unsigned)b;
+	unsigned q;
 
+	/* Shift-subtract divider runs in at most 32 steps. */
+	q = __udivmodsi4(ua, ub, 0);
+
+	return ((int)(((a < 0) != (b < 0)) ? -q : q));
+
+#endif
+}
@@ -0,0 +1,478 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Division by invariant integers, after libdivide.
+ *
+ * Source: https://github.com/ridiculousfish/libdivide
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stdint.h>
+
+/**
+ * @name Divider Flags
+ */
+/**@{*/
+#define DIV_SHIFT_MASK_32  0x1f /**< Shift amount for 32-bit dividers.  */
+#define DIV_SHIFT_MASK_64  0x3f /**< Shift amount for 64-bit dividers.  */
+#define DIV_ADD_MARKER     0x40 /**< Magic number has 33/65 bits.       */
+#define DIV_NEGATIVE       0x80 /**< Divisor is negative.               */
+/**@}*/
+
+/*============================================================================*
+ * Helpers                                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Returns the high half of a 32x32-bit unsigned product.
+ */
+static inline uint32_t mulhi_u32(uint32_t x, uint32_t y)
+{
+	return ((uint32_t)(((uint64_t)x * y) >> 32));
+}
+
+/**
+ * @brief Returns the high half of a 32x32-bit signed product.
+ */
+static inline int32_t mulhi_s32(int32_t x, int32_t y)
+{
+	return ((int32_t)(((int64_t)x * y) >> 32));
+}
+
+#ifdef __SIZEOF_INT128__
+
+__extension__ typedef unsigned __int128 uint128_t;
+__extension__ typedef __int128 int128_t;
+
+/**
+ * @brief Returns the high half of a 64x64-bit unsigned product.
+ */
+static inline uint64_t mulhi_u64(uint64_t x, uint64_t y)
+{
+	return ((uint64_t)(((uint128_t)x * y) >> 64));
+}
+
+/**
+ * @brief Returns the high half of a 64x64-bit signed product.
+ */
+static inline int64_t mulhi_s64(int64_t x, int64_t y)
+{
+	return ((int64_t)(((int128_t)x * y) >> 64));
+}
+
+#else
+
+/**
+ * @brief Returns the high half of a 64x64-bit unsigned product.
+ */
+static inline uint64_t mulhi_u64(uint64_t x, uint64_t y)
+{
+	uint64_t xlo = (uint32_t)x, xhi = x >> 32;
+	uint64_t ylo = (uint32_t)y, yhi = y >> 32;
+	uint64_t lolo = xlo*ylo;
+	uint64_t hilo = xhi*ylo;
+	uint64_t lohi = xlo*yhi;
+	uint64_t cross = (lolo >> 32) + (uint32_t)hilo + lohi;
+
+	return ((hilo >> 32) + (cross >> 32) + xhi*yhi);
+}
+
+/**
+ * @brief Returns the high half of a 64x64-bit signed product.
+ */
+static inline int64_t mulhi_s64(int64_t x, int64_t y)
+{
+	uint64_t hi = mulhi_u64(x, y);
+
+	/* Correct the unsigned product for negative operands. */
+	if (x < 0)
+		hi -= y;
+	if (y < 0)
+		hi -= x;
+
+	return ((int64_t)hi);
+}
+
+#endif
+
+/**
+ * @brief Divides a 128-bit integer by a 64-bit one.
+ *
+ * @param hi  High half of dividend (must be less than @p den).
+ * @param lo  Low half of dividend.
+ * @param den Divisor.
+ * @param rem Location to store the remainder.
+ *
+ * @returns The quotient, which fits in 64 bits because @p hi is less
+ * than @p den.
+ */
+static uint64_t div128_64(uint64_t hi, uint64_t lo, uint64_t den, uint64_t *rem)
+{
+	int i;
+
+	for (i = 0; i < 64; i++)
+	{
+		uint64_t carry = hi >> 63;
+
+		hi = (hi << 1) | (lo >> 63);
+		lo <<= 1;
+
+		if (carry || (hi >= den))
+		{
+			hi -= den;
+			lo |= 1;
+		}
+	}
+
+	*rem = hi;
+
+	return (lo);
+}
+
+/*============================================================================*
+ * 32-bit Dividers                                                            *
+ *============================================================================*/
+
+/**
+ * The divu32_init() function initializes the divider pointed to by
+ * @p div with the reciprocal of @p divisor.
+ */
+void divu32_init(divu32_t *div, uint32_t divisor)
+{
+	uint32_t log2d = 31 - __builtin_clz(divisor);
+
+	div->divisor = divisor;
+
+	/* Power of two. */
+	if ((divisor & (divisor - 1)) == 0)
+	{
+		div->magic = 0;
+		div->more = log2d;
+	}
+	else
+	{
+		uint64_t m = ((uint64_t)1 << (32 + log2d)) / divisor;
+		uint32_t rem = ((uint64_t)1 << (32 + log2d)) - m*divisor;
+
+		/* Magic number fits in 32 bits. */
+		if ((divisor - rem) < ((uint32_t)1 << log2d))
+			div->more = log2d;
+
+		/* Magic number needs an extra bit. */
+		else
+		{
+			uint32_t twice_rem = rem + rem;
+
+			m += m;
+			if ((twice_rem >= divisor) || (twice_rem < rem))
+				m++;
+			div->more = log2d | DIV_ADD_MARKER;
+		}
+
+		div->magic = (uint32_t)m + 1;
+	}
+}
+
+/**
+ * The divu32_div() function divides @p n by the divisor of @p div.
+ */
+uint32_t divu32_div(const divu32_t *div, uint32_t n)
+{
+	uint32_t q;
+
+	/* Power of two. */
+	if (div->magic == 0)
+		return (n >> div->more);
+
+	q = mulhi_u32(div->magic, n);
+
+	if (div->more & DIV_ADD_MARKER)
+		return ((((n - q) >> 1) + q) >> (div->more & DIV_SHIFT_MASK_32));
+
+	return (q >> div->more);
+}
+
+/**
+ * The divu32_mod() function computes @p n module the divisor of @p div.
+ */
+uint32_t divu32_mod(const divu32_t *div, uint32_t n)
+{
+	return (n - divu32_div(div, n)*div->divisor);
+}
+
+/**
+ * The divs32_init() function initializes the divider pointed to by
+ * @p div with the reciprocal of @p divisor.
+ */
+void divs32_init(divs32_t *div, int32_t divisor)
+{
+	uint32_t absd = (divisor < 0) ? -(uint32_t)divisor : (uint32_t)divisor;
+	uint32_t log2d = 31 - __builtin_clz(absd);
+
+	div->divisor = divisor;
+
+	/* Power of two. */
+	if ((absd & (absd - 1)) == 0)
+	{
+		div->magic = 0;
+		div->more = log2d | ((divisor < 0) ? DIV_NEGATIVE : 0);
+	}
+	else
+	{
+		uint64_t m = ((uint64_t)1 << (31 + log2d)) / absd;
+		uint32_t rem = ((uint64_t)1 << (31 + log2d)) - m*absd;
+		uint32_t magic;
+
+		/* Magic number fits in 32 bits. */
+		if ((absd - rem) < ((uint32_t)1 << log2d))
+			div->more = log2d - 1;
+
+		/* Magic number needs an extra bit. */
+		else
+		{
+			uint32_t twice_rem = rem + rem;
+
+			m += m;
+			if ((twice_rem >= absd) || (twice_rem < rem))
+				m++;
+			div->more = log2d | DIV_ADD_MARKER;
+		}
+
+		magic = (uint32_t)m + 1;
+
+		/* Fold the sign of the divisor into the magic number. */
+		if (divisor < 0)
+		{
+			div->more |= DIV_NEGATIVE;
+			magic = -magic;
+		}
+
+		div->magic = (int32_t)magic;
+	}
+}
+
+/**
+ * The divs32_div() function divides @p n by the divisor of @p div,
+ * rounding towards zero.
+ */
+int32_t divs32_div(const divs32_t *div, int32_t n)
+{
+	uint32_t shift = div->more & DIV_SHIFT_MASK_32;
+	uint32_t sign = (div->more & DIV_NEGATIVE) ? ~0U : 0;
+	uint32_t uq;
+	int32_t q;
+
+	/* Power of two. */
+	if (div->magic == 0)
+	{
+		/* Round negative dividends towards zero. */
+		uq = (uint32_t)n + (((uint32_t)(n >> 31)) & ((1U << shift) - 1));
+		q = (int32_t)uq >> shift;
+
+		return ((q ^ sign) - sign);
+	}
+
+	uq = (uint32_t)mulhi_s32(div->magic, n);
+
+	if (div->more & DIV_ADD_MARKER)
+		uq += ((uint32_t)n ^ sign) - sign;
+
+	q = (int32_t)uq >> shift;
+	q += (q < 0);
+
+	return (q);
+}
+
+/**
+ * The divs32_mod() function computes @p n module the divisor of @p div.
+ * The result has the sign of @p n.
+ */
+int32_t divs32_mod(const divs32_t *div, int32_t n)
+{
+	return ((int32_t)((uint32_t)n - (uint32_t)divs32_div(div, n)*(uint32_t)div->divisor));
+}
+
+/*============================================================================*
+ * 64-bit Dividers                                                            *
+ *============================================================================*/
+
+/**
+ * The divu64_init() function initializes the divider pointed to by
+ * @p div with the reciprocal of @p divisor.
+ */
+void divu64_init(divu64_t *div, uint64_t divisor)
+{
+	uint32_t log2d = 63 - __builtin_clzll(divisor);
+
+	div->divisor = divisor;
+
+	/* Power of two. */
+	if ((divisor & (divisor - 1)) == 0)
+	{
+		div->magic = 0;
+		div->more = log2d;
+	}
+	else
+	{
+		uint64_t rem;
+		uint64_t m = div128_64((uint64_t)1 << log2d, 0, divisor, &rem);
+
+		/* Magic number fits in 64 bits. */
+		if ((divisor - rem) < ((uint64_t)1 << log2d))
+			div->more = log2d;
+
+		/* Magic number needs an extra bit. */
+		else
+		{
+			uint64_t twice_rem = rem + rem;
+
+			m += m;
+			if ((twice_rem >= divisor) || (twice_rem < rem))
+				m++;
+			div->more = log2d | DIV_ADD_MARKER;
+		}
+
+		div->magic = m + 1;
+	}
+}
+
+/**
+ * The divu64_div() function divides @p n by the divisor of @p div.
+ */
+uint64_t divu64_div(const divu64_t *div, uint64_t n)
+{
+	uint64_t q;
+
+	/* Power of two. */
+	if (div->magic == 0)
+		return (n >> div->more);
+
+	q = mulhi_u64(div->magic, n);
+
+	if (div->more & DIV_ADD_MARKER)
+		return ((((n - q) >> 1) + q) >> (div->more & DIV_SHIFT_MASK_64));
+
+	return (q >> div->more);
+}
+
+/**
+ * The divu64_mod() function computes @p n module the divisor of @p div.
+ */
+uint64_t divu64_mod(const divu64_t *div, uint64_t n)
+{
+	return (n - divu64_div(div, n)*div->divisor);
+}
+
+/**
+ * The divs64_init() function initializes the divider pointed to by
+ * @p div with the reciprocal of @p divisor.
+ */
+void divs64_init(divs64_t *div, int64_t divisor)
+{
+	uint64_t absd = (divisor < 0) ? -(uint64_t)divisor : (uint64_t)divisor;
+	uint32_t log2d = 63 - __builtin_clzll(absd);
+
+	div->divisor = divisor;
+
+	/* Power of two. */
+	if ((absd & (absd - 1)) == 0)
+	{
+		div->magic = 0;
+		div->more = log2d | ((divisor < 0) ? DIV_NEGATIVE : 0);
+	}
+	else
+	{
+		uint64_t rem;
+		uint64_t m = div128_64((uint64_t)1 << (log2d - 1), 0, absd, &rem);
+		uint64_t magic;
+
+		/* Magic number fits in 64 bits. */
+		if ((absd - rem) < ((uint64_t)1 << log2d))
+			div->more = log2d - 1;
+
+		/* Magic number needs an extra bit. */
+		else
+		{
+			uint64_t twice_rem = rem + rem;
+
+			m += m;
+			if ((twice_rem >= absd) || (twice_rem < rem))
+				m++;
+			div->more = log2d | DIV_ADD_MARKER;
+		}
+
+		magic = m + 1;
+
+		/* Fold the sign of the divisor into the magic number. */
+		if (divisor < 0)
+		{
+			div->more |= DIV_NEGATIVE;
+			magic = -magic;
+		}
+
+		div->magic = (int64_t)magic;
+	}
+}
+
+/**
+ * The divs64_div() function divides @p n by the divisor of @p div,
+ * rounding towards zero.
+ */
+int64_t divs64_div(const divs64_t *div, int64_t n)
+{
+	uint32_t shift = div->more & DIV_SHIFT_MASK_64;
+	uint64_t sign = (div->more & DIV_NEGATIVE) ? ~0ULL : 0;
+	uint64_t uq;
+	int64_t q;
+
+	/* Power of two. */
+	if (div->magic == 0)
+	{
+		/* Round negative dividends towards zero. */
+		uq = (uint64_t)n + (((uint64_t)(n >> 63)) & ((1ULL << shift) - 1));
+		q = (int64_t)uq >> shift;
+
+		return ((q ^ sign) - sign);
+	}
+
+	uq = (uint64_t)mulhi_s64(div->magic, n);
+
+	if (div->more & DIV_ADD_MARKER)
+		uq += ((uint64_t)n ^ sign) - sign;
+
+	q = (int64_t)uq >> shift;
+	q += (q < 0);
+
+	return (q);
+}
+
+/**
+ * The divs64_mod() function computes @p n module the divisor of @p div.
+ * The result has the sign of @p n.
+ */
+int64_t divs64_mod(const divs64_t *div, int64_t n)
+{
+	return ((int64_t)((uint64_t)n - (uint64_t)divs64_div(div, n)*(uint64_t)div->divisor));
+}
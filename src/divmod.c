@@ -92,3 +92,75 @@ long __modsi3(long a, long b)
 	return res;
 }
 
+/**
+ * @brief Divides two long long integers.
+ *
+ * @param a First operand.
+ * @param b Second operand.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The result of @p a divided by @p b.
+ */
+long long __divdi3(long long a, long long b)
+{
+	int neg = 0;
+	unsigned long long ua = a;
+	unsigned long long ub = b;
+	long long res;
+
+	if (a < 0)
+	{
+		ua  = -ua;
+		neg = !neg;
+	}
+
+	if (b < 0)
+	{
+		ub  = -ub;
+		neg = !neg;
+	}
+
+	res = __udivmoddi4(ua, ub, NULL);
+
+	if (neg)
+		res = -res;
+
+	return res;
+}
+
+/**
+ * @brief Module between two long long integers.
+ *
+ * @param a First operand.
+ * @param b Second operand.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The result of @p a module by @p b.
+ */
+long long __moddi3(long long a, long long b)
+{
+	int neg = 0;
+	unsigned long long ua = a;
+	unsigned long long ub = b;
+	unsigned long long rem;
+	long long res;
+
+	if (a < 0)
+	{
+		ua  = -ua;
+		neg = 1;
+	}
+
+	if (b < 0)
+		ub = -ub;
+
+	__udivmoddi4(ua, ub, &rem);
+
+	res = rem;
+	if (neg)
+		res = -res;
+
+	return res;
+}
@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stddef.h>
+#include <posix/stdint.h>
+
+/**
+ * The hbitmap_size() function returns the size (in bytes) of the
+ * storage needed by a hierarchical bitmap of @p nbits bits. Levels are
+ * laid out one after the other, leaf level first.
+ */
+size_t hbitmap_size(size_t nbits)
+{
+	size_t nwords;
+	size_t size = 0;
+
+	do
+	{
+		nwords = BITMAP_NWORDS(nbits);
+		size += nwords*sizeof(bitmap_t);
+		nbits = nwords;
+	} while (nwords > 1);
+
+	return (size);
+}
+
+/**
+ * The hbitmap_init() function initializes the hierarchical bitmap
+ * pointed to by @p hb, of @p nbits bits, on top of the storage pointed
+ * to by @p storage. Padding bits past the end of each level are set, so
+ * they are never handed out and never keep a word from being full.
+ */
+int hbitmap_init(hbitmap_t *hb, bitmap_t *storage, size_t nbits)
+{
+	unsigned l;
+	size_t pos;
+	size_t nwords;
+
+	if (nbits == 0)
+		return (-1);
+
+	hb->nbits = nbits;
+
+	/* Lay out levels. */
+	for (l = 0; /* noop */; l++)
+	{
+		if (l >= HBITMAP_MAX_LEVELS)
+			return (-1);
+
+		nwords = BITMAP_NWORDS(nbits);
+		hb->levels[l] = storage;
+
+		__memset(storage, 0, nwords*sizeof(bitmap_t));
+		for (pos = nbits; pos < (nwords << BITMAP_WORD_SHIFT); pos++)
+			bitmap_set(storage, pos);
+
+		if (nwords == 1)
+			break;
+
+		storage += nwords;
+		nbits = nwords;
+	}
+
+	hb->nlevels = l + 1;
+
+	/* Summarize last words that padding filled up. */
+	for (l = 0; l < (hb->nlevels - 1); l++)
+	{
+		nwords = hb->levels[l + 1] - hb->levels[l];
+
+		if (hb->levels[l][nwords - 1] == BITMAP_FULL)
+			bitmap_set(hb->levels[l + 1], nwords - 1);
+	}
+
+	return (0);
+}
+
+/**
+ * The hbitmap_set() function sets the bit @p pos of the hierarchical
+ * bitmap pointed to by @p hb. If that fills up its word, the word is
+ * marked as full in the level above, and so on.
+ */
+void hbitmap_set(hbitmap_t *hb, bitmap_t pos)
+{
+	unsigned l;
+
+	for (l = 0; l < hb->nlevels; l++)
+	{
+		bitmap_set(hb->levels[l], pos);
+
+		/* Word is not full. */
+		if (hb->levels[l][IDX(pos)] != BITMAP_FULL)
+			break;
+
+		pos = IDX(pos);
+	}
+}
+
+/**
+ * The hbitmap_clear() function clears the bit @p pos of the
+ * hierarchical bitmap pointed to by @p hb. If its word was full, the
+ * word is marked as not full in the level above, and so on.
+ */
+void hbitmap_clear(hbitmap_t *hb, bitmap_t pos)
+{
+	unsigned l;
+	int full;
+
+	for (l = 0; l < hb->nlevels; l++)
+	{
+		full = (hb->levels[l][IDX(pos)] == BITMAP_FULL);
+
+		bitmap_clear(hb->levels[l], pos);
+
+		/* Word was not full. */
+		if (!full)
+			break;
+
+		pos = IDX(pos);
+	}
+}
+
+/**
+ * The hbitmap_check_bit() function returns the value of the bit @p pos
+ * of the hierarchical bitmap pointed to by @p hb.
+ */
+bitmap_t hbitmap_check_bit(const hbitmap_t *hb, bitmap_t pos)
+{
+	return (hb->levels[0][IDX(pos)] & (0x1U << OFF(pos)));
+}
+
+/**
+ * The hbitmap_first_free() function searches for the first bit that is
+ * cleared in the hierarchical bitmap pointed to by @p hb. The search
+ * walks down from the topmost level, following the first word that is
+ * not full at each level.
+ */
+bitmap_t hbitmap_first_free(const hbitmap_t *hb)
+{
+	unsigned l;
+	bitmap_t idx = 0;
+
+	/* Bitmap is full. */
+	if (hb->levels[hb->nlevels - 1][0] == BITMAP_FULL)
+		return (BITMAP_FULL);
+
+	for (l = hb->nlevels; l-- > 0; /* noop */)
+		idx = (idx << BITMAP_WORD_SHIFT) + __builtin_ctz(~hb->levels[l][idx]);
+
+	return (idx);
+}
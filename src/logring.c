@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stdarg.h>
+#include <posix/stddef.h>
+#include <posix/stdint.h>
+
+/**
+ * The logring_init() function initializes the log ring pointed to by
+ * @p ring, on top of the array of @p nrecords records pointed to by
+ * @p records. If @p clock is not NULL, it timestamps every record. The
+ * number of records is a power of two, so that the owner indexes
+ * records with a mask rather than with a division.
+ */
+int logring_init(logring_t *ring, logring_record_t *records, size_t nrecords, uint64_t (*clock)(void))
+{
+	/* Not a power of two. */
+	if ((nrecords == 0) || (nrecords & (nrecords - 1)))
+		return (-1);
+
+	ring->records = records;
+	ring->nrecords = nrecords;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->limit = 0;
+	ring->dropped = 0;
+	ring->clock = clock;
+
+	return (0);
+}
+
+/**
+ * The logring_printf() function formats a message straight into the
+ * next free record of the log ring pointed to by @p ring. It must only
+ * be called by the owner of the ring, and it takes no locks: the
+ * record is published to the reader with a release store. If the ring
+ * is full, the message is dropped and counted.
+ */
+int logring_printf(logring_t *ring, const char *fmt, ...)
+{
+	size_t head, tail;
+	logring_record_t *rec;
+	va_list args;
+
+	tail = ring->tail;
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	/* Ring is full. */
+	if ((tail - head) >= ring->nrecords)
+	{
+		__atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+		return (-1);
+	}
+
+	rec = &ring->records[tail & (ring->nrecords - 1)];
+	rec->timestamp = (ring->clock != NULL) ? ring->clock() : 0;
+
+	va_start(args, fmt);
+	__vsnprintf(rec->msg, LOGRING_MSG_SIZE, fmt, args);
+	va_end(args);
+
+	/* Publish record. */
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return (0);
+}
+
+/**
+ * The logring_flush() function merges the records of the @p nrings log
+ * rings pointed to by @p rings in timestamp order, and writes them to
+ * the output sink @p write. Each message is prefixed with its
+ * timestamp and the index of its ring. Records published while the
+ * rings are flushed are left for the next flush.
+ */
+int logring_flush(logring_t *rings, unsigned nrings, fmt_sink_t write, void *ctx)
+{
+	int n = 0;
+	unsigned i;
+
+	if (write == NULL)
+		return (-1);
+
+	/* Snapshot published records, so that the merge terminates. */
+	for (i = 0; i < nrings; i++)
+		rings[i].limit = __atomic_load_n(&rings[i].tail, __ATOMIC_ACQUIRE);
+
+	while (1)
+	{
+		logring_t *oldest = NULL;
+		const logring_record_t *rec = NULL;
+		const logring_record_t *r;
+
+		/* Pick the oldest pending record. */
+		for (i = 0; i < nrings; i++)
+		{
+			if (rings[i].head == rings[i].limit)
+				continue;
+
+			r = &rings[i].records[rings[i].head & (rings[i].nrecords - 1)];
+
+			if ((rec == NULL) || (r->timestamp < rec->timestamp))
+			{
+				oldest = &rings[i];
+				rec = r;
+			}
+		}
+
+		/* Done. */
+		if (oldest == NULL)
+			break;
+
+		__cbprintf(write, ctx, "[%llu] [%u] %s",
+			(unsigned long long)rec->timestamp, (unsigned)(oldest - rings), rec->msg
+		);
+
+		/* Release record to the producer. */
+		__atomic_store_n(&oldest->head, oldest->head + 1, __ATOMIC_RELEASE);
+		n++;
+	}
+
+	return (n);
+}
@@ -24,6 +24,14 @@
 
 #include <posix/stddef.h>
 
+/*
+ * On x86-64 hosts this is the fallback kernel of the runtime
+ * dispatcher, which provides the public symbol (see memx86_64.c).
+ */
+#if defined(__unix64__) && defined(__x86_64__)
+#define __memchr __memchr_generic
+#endif
+
 /**
  * The __memchr() function locates the first occurrence of @p c
  * (converted to an unsigned char) in the initial @p n characters
@@ -39,7 +47,7 @@ void *__memchr(const void *s, int c, size_t n)
 	/* Search byte. */
 	while (n-- > 0)
 	{
-		if (*p++ == c)
+		if (*p++ == (unsigned char) c)
 			return ((void *)(p - 1));
 	}
 
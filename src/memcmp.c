@@ -24,6 +24,14 @@
 
 #include <posix/stddef.h>
 
+/*
+ * On x86-64 hosts this is the fallback kernel of the runtime
+ * dispatcher, which provides the public symbol (see memx86_64.c).
+ */
+#if defined(__unix64__) && defined(__x86_64__)
+#define __memcmp __memcmp_generic
+#endif
+
 /**
  * The __memcmp() function compares the first @p n characters of the
  * object pointed to by @p s1 to the first @p n characters of the
@@ -24,9 +24,16 @@
 
 #include <posix/stddef.h>
 
-/* Nonzero if either X or Y is not aligned on a "long" boundary.  */
-#define UNALIGNED(X, Y) \
-  (((long)X & (sizeof (long) - 1)) | ((long)Y & (sizeof (long) - 1)))
+/*
+ * On x86-64 hosts this is the fallback kernel of the runtime
+ * dispatcher, which provides the public symbol (see memx86_64.c).
+ */
+#if defined(__unix64__) && defined(__x86_64__)
+#define __memcpy __memcpy_generic
+#endif
+
+/* Offset of X from the previous "long" boundary.  */
+#define MISALIGNMENT(X) ((long)X & (sizeof (long) - 1))
 
 /* How many bytes are copied each iteration of the 4X unrolled loop.  */
 #define BIGBLOCKSIZE    (sizeof (long) << 2)
@@ -37,6 +44,17 @@
 /* Threshhold for punting to the byte copier.  */
 #define TOO_SMALL(LEN)  ((LEN) < BIGBLOCKSIZE)
 
+/* Merges the tail of long word X with the head of long word Y.  */
+#if !defined(__BYTE_ORDER__)
+#error "__BYTE_ORDER__ is required to merge misaligned words"
+#elif (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define MERGE(X, XSHIFT, Y, YSHIFT) (((X) << (XSHIFT)) | ((Y) >> (YSHIFT)))
+#elif (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MERGE(X, XSHIFT, Y, YSHIFT) (((X) >> (XSHIFT)) | ((Y) << (YSHIFT)))
+#else
+#error "unsupported byte order"
+#endif
+
 /**
  * The __memcpy() function copies @p n characters from the object
  * pointed to by @p s2 into the object pointed to by @p s1. If copying
@@ -50,33 +68,88 @@ void *__memcpy(void *s1, const void *s2, size_t n)
 	long *aligned_dst;
 	const long *aligned_src;
 
-	/* If the size is small, or either SRC or DST is unaligned,
-	   then punt into the byte copy loop.	This should be rare. */
-	if (!TOO_SMALL(n) && !UNALIGNED (src, dst))
+	/* If the size is small, punt into the byte copy loop. */
+	if (!TOO_SMALL(n))
 	{
+		/* Copy bytes until the target area is aligned. */
+		while (MISALIGNMENT(dst))
+		{
+			*dst++ = *src++;
+			n--;
+		}
+
 		aligned_dst = (long*)dst;
-		aligned_src = (long*)src;
 
-		/* Copy 4X long words at a time if possible. */
-		while (n >= BIGBLOCKSIZE)
+		if (!MISALIGNMENT(src))
 		{
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			n -= BIGBLOCKSIZE;
+			aligned_src = (long*)src;
+
+			/* Copy 4X long words at a time if possible. */
+			while (n >= BIGBLOCKSIZE)
+			{
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				n -= BIGBLOCKSIZE;
+			}
+
+			/* Copy one long word at a time if possible. */
+			while (n >= LITTLEBLOCKSIZE)
+			{
+				*aligned_dst++ = *aligned_src++;
+				n -= LITTLEBLOCKSIZE;
+			}
+
+			/* Pick up any residual with a byte copier. */
+			src = (char*)aligned_src;
 		}
 
-		/* Copy one long word at a time if possible. */
-		while (n >= LITTLEBLOCKSIZE)
+		/*
+		 * The source area is misaligned, so read aligned long words
+		 * from it and merge consecutive ones with shifts. Every word
+		 * that is read holds at least one byte to be copied.
+		 */
+		else
 		{
-			*aligned_dst++ = *aligned_src++;
-			n -= LITTLEBLOCKSIZE;
+			unsigned long w0, w1;
+			unsigned lshift, rshift;
+			long off = MISALIGNMENT(src);
+
+			rshift = off << 3;
+			lshift = (LITTLEBLOCKSIZE << 3) - rshift;
+			aligned_src = (long*)(src - off);
+
+			w0 = *aligned_src++;
+
+			/* Copy 4X long words at a time if possible. */
+			while (n >= BIGBLOCKSIZE)
+			{
+				w1 = *aligned_src++;
+				*aligned_dst++ = MERGE(w0, rshift, w1, lshift);
+				w0 = *aligned_src++;
+				*aligned_dst++ = MERGE(w1, rshift, w0, lshift);
+				w1 = *aligned_src++;
+				*aligned_dst++ = MERGE(w0, rshift, w1, lshift);
+				w0 = *aligned_src++;
+				*aligned_dst++ = MERGE(w1, rshift, w0, lshift);
+				n -= BIGBLOCKSIZE;
+			}
+
+			/* Copy one long word at a time if possible. */
+			while (n >= LITTLEBLOCKSIZE)
+			{
+				w1 = *aligned_src++;
+				*aligned_dst++ = MERGE(w0, rshift, w1, lshift);
+				w0 = w1;
+				n -= LITTLEBLOCKSIZE;
+			}
+
+			/* Pick up any residual with a byte copier. */
+			src = (char*)(aligned_src - 1) + off;
 		}
 
-		/* Pick up any residual with a byte copier. */
 		dst = (char*)aligned_dst;
-		src = (char*)aligned_src;
 	}
 
 	while (n--)
@@ -84,3 +157,17 @@ void *__memcpy(void *s1, const void *s2, size_t n)
 
 	return s1;
 }
+
+#if !(defined(__unix64__) && defined(__x86_64__))
+
+/**
+ * The __memcpy_nt() function copies @p n characters from the object
+ * pointed to by @p s2 into the object pointed to by @p s1. This target
+ * has no cache-bypassing stores, so this is a regular copy.
+ */
+void *__memcpy_nt(void *s1, const void *s2, size_t n)
+{
+	return (__memcpy(s1, s2, n));
+}
+
+#endif
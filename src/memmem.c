@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stddef.h>
+
+/* Invalid index, which also stands for -1 in index arithmetics.  */
+#define NOIDX ((size_t) -1)
+
+/**
+ * @brief Computes a critical factorization of a string.
+ *
+ * @details The string is split into a left and a right half, so that
+ * the local period at the split point is as large as the global period
+ * of the string. The split point is taken as the larger of the two
+ * maximal suffixes of @p x, one for each ordering of the alphabet.
+ *
+ * @param x      Target string.
+ * @param m      Length of @p x (at least 1).
+ * @param period Location to store the period of the right half.
+ *
+ * @returns The index where the right half of @p x starts.
+ */
+static size_t critical_factorization(const unsigned char *x, size_t m, size_t *period)
+{
+	size_t ms[2]; /* Maximal suffixes.    */
+	size_t ps[2]; /* Their periods.       */
+	size_t j;     /* Candidate suffix.    */
+	size_t k;     /* Offset in candidate. */
+	size_t p;     /* Current period.      */
+	int rev;      /* Reverse ordering?    */
+
+	/* Trivial factorization. */
+	if (m < 3)
+	{
+		*period = 1;
+		return (m - 1);
+	}
+
+	for (rev = 0; rev < 2; rev++)
+	{
+		ms[rev] = NOIDX;
+		j = 0;
+		k = p = 1;
+
+		while (j + k < m)
+		{
+			unsigned char a = x[j + k];
+			unsigned char b = x[ms[rev] + k];
+
+			/* Candidate is smaller, so it's not maximal. */
+			if ((rev) ? (b < a) : (a < b))
+			{
+				j += k;
+				k = 1;
+				p = j - ms[rev];
+			}
+
+			/* Candidate matches so far. */
+			else if (a == b)
+			{
+				if (k != p)
+					k++;
+				else
+				{
+					j += p;
+					k = 1;
+				}
+			}
+
+			/* Candidate is the new maximal suffix. */
+			else
+			{
+				ms[rev] = j++;
+				k = p = 1;
+			}
+		}
+
+		ps[rev] = p;
+	}
+
+	/* Pick up the larger maximal suffix. */
+	if (ms[1] + 1 < ms[0] + 1)
+	{
+		*period = ps[0];
+		return (ms[0] + 1);
+	}
+
+	*period = ps[1];
+	return (ms[1] + 1);
+}
+
+/**
+ * The __memmem() function locates the first occurrence of the @p nlen
+ * bytes long object pointed to by @p needle in the @p hlen bytes long
+ * object pointed to by @p haystack.
+ *
+ * It uses the Two-Way algorithm by Crochemore and Perrin, which runs in
+ * linear time and constant space.
+ */
+void *__memmem(const void *haystack, size_t hlen, const void *needle, size_t nlen)
+{
+	const unsigned char *h = haystack;
+	const unsigned char *n = needle;
+	size_t suffix; /* Start of right half of needle. */
+	size_t period; /* Period of needle.              */
+	size_t i, j;
+
+	/* Empty needles match anywhere. */
+	if (nlen == 0)
+		return ((void *) h);
+
+	/* Needle does not fit. */
+	if (nlen > hlen)
+		return (NULL);
+
+	suffix = critical_factorization(n, nlen, &period);
+
+	/*
+	 * Needle is periodic, so remember how much of its prefix
+	 * is known to match after a shift of one period.
+	 */
+	if (__memcmp(n, n + period, suffix) == 0)
+	{
+		size_t memory = 0;
+
+		for (j = 0; j <= hlen - nlen; /* noop */)
+		{
+			/* Match right half. */
+			i = (suffix > memory) ? suffix : memory;
+			while ((i < nlen) && (n[i] == h[i + j]))
+				i++;
+
+			if (i < nlen)
+			{
+				j += i - suffix + 1;
+				memory = 0;
+				continue;
+			}
+
+			/* Match left half. */
+			i = suffix - 1;
+			while ((memory < i + 1) && (n[i] == h[i + j]))
+				i--;
+
+			/* Found. */
+			if (i + 1 < memory + 1)
+				return ((void *)(h + j));
+
+			j += period;
+			memory = nlen - period;
+		}
+	}
+
+	/*
+	 * Halves of the needle do not overlap in a period, so a
+	 * mismatch in the left half shifts the needle further.
+	 */
+	else
+	{
+		period = ((suffix > nlen - suffix) ? suffix : nlen - suffix) + 1;
+
+		for (j = 0; j <= hlen - nlen; /* noop */)
+		{
+			/* Match right half. */
+			i = suffix;
+			while ((i < nlen) && (n[i] == h[i + j]))
+				i++;
+
+			if (i < nlen)
+			{
+				j += i - suffix + 1;
+				continue;
+			}
+
+			/* Match left half. */
+			i = suffix - 1;
+			while ((i != NOIDX) && (n[i] == h[i + j]))
+				i--;
+
+			/* Found. */
+			if (i == NOIDX)
+				return ((void *)(h + j));
+
+			j += period;
+		}
+	}
+
+	return (NULL);
+}
@@ -55,8 +55,24 @@
  * SUCH DAMAGE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
+/* Nonzero if X is not aligned on a "long" boundary.  */
+#define UNALIGNED(X) ((long)X & (LITTLEBLOCKSIZE - 1))
+
+/* Nonzero if X and Y cannot be aligned on a "long" boundary together.  */
+#define MISALIGNED(X, Y) (((long)X ^ (long)Y) & (LITTLEBLOCKSIZE - 1))
+
+/* How many bytes are copied each iteration of the 4X unrolled loop.  */
+#define BIGBLOCKSIZE    (sizeof (long) << 2)
+
+/* How many bytes are copied each iteration of the word copy loop.  */
+#define LITTLEBLOCKSIZE (sizeof (long))
+
+/* Threshhold for punting to the byte copier.  */
+#define TOO_SMALL(LEN)  ((LEN) < BIGBLOCKSIZE)
+
 /**
  * The __memmove() function copies @p n characters from the object
  * pointed to by @p s2 into the object pointed to by @p s1. Copying
@@ -68,25 +84,96 @@
  */
 void *__memmove(void *s1, const void *s2, size_t n)
 {
-	char *p1;
-	const char *p2;
+	char *dst = s1;
+	const char *src = s2;
+	long *aligned_dst;
+	const long *aligned_src;
 
-	p1 = s1;
-	p2 = s2;
+	/* Objects do not overlap, so use the fast copier. */
+	if ((dst + n <= src) || (src + n <= dst))
+		return (__memcpy(s1, s2, n));
 
 	/* Have to copy backwards */
-	if (p2 < p1 && p1 < p2 + n)
+	if (src < dst)
 	{
-		p2 += n; p1 += n;
+		src += n; dst += n;
+
+		if (!TOO_SMALL(n) && !MISALIGNED(src, dst))
+		{
+			/* Copy bytes until both ends are aligned. */
+			while (UNALIGNED(dst))
+			{
+				*--dst = *--src;
+				n--;
+			}
+
+			aligned_dst = (long *)dst;
+			aligned_src = (const long *)src;
+
+			/* Copy 4X long words at a time if possible. */
+			while (n >= BIGBLOCKSIZE)
+			{
+				*--aligned_dst = *--aligned_src;
+				*--aligned_dst = *--aligned_src;
+				*--aligned_dst = *--aligned_src;
+				*--aligned_dst = *--aligned_src;
+				n -= BIGBLOCKSIZE;
+			}
+
+			/* Copy one long word at a time if possible. */
+			while (n >= LITTLEBLOCKSIZE)
+			{
+				*--aligned_dst = *--aligned_src;
+				n -= LITTLEBLOCKSIZE;
+			}
+
+			/* Pick up any residual with a byte copier. */
+			dst = (char *)aligned_dst;
+			src = (const char *)aligned_src;
+		}
 
 		while (n-- > 0)
-			*--p1 = *--p2;
+			*--dst = *--src;
 	}
 
 	else
 	{
+		if (!TOO_SMALL(n) && !MISALIGNED(src, dst))
+		{
+			/* Copy bytes until both starts are aligned. */
+			while (UNALIGNED(dst))
+			{
+				*dst++ = *src++;
+				n--;
+			}
+
+			aligned_dst = (long *)dst;
+			aligned_src = (const long *)src;
+
+			/* Copy 4X long words at a time if possible. */
+			while (n >= BIGBLOCKSIZE)
+			{
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				n -= BIGBLOCKSIZE;
+			}
+
+			/* Copy one long word at a time if possible. */
+			while (n >= LITTLEBLOCKSIZE)
+			{
+				*aligned_dst++ = *aligned_src++;
+				n -= LITTLEBLOCKSIZE;
+			}
+
+			/* Pick up any residual with a byte copier. */
+			dst = (char *)aligned_dst;
+			src = (const char *)aligned_src;
+		}
+
 		while (n-- > 0)
-			*p1++ = *p2++;
+			*dst++ = *src++;
 	}
 
 	return (s1);
@@ -24,6 +24,26 @@
 
 #include <posix/stddef.h>
 
+/*
+ * On x86-64 hosts this is the fallback kernel of the runtime
+ * dispatcher, which provides the public symbol (see memx86_64.c).
+ */
+#if defined(__unix64__) && defined(__x86_64__)
+#define __memset __memset_generic
+#endif
+
+/* Nonzero if X is not aligned on a "long" boundary.  */
+#define UNALIGNED(X) ((long)X & (LBLOCKSIZE - 1))
+
+/* How many bytes are set each iteration of the word set loop.  */
+#define LBLOCKSIZE (sizeof (long))
+
+/* How many bytes are set each iteration of the 4X unrolled loop.  */
+#define BIGBLOCKSIZE (LBLOCKSIZE << 2)
+
+/* Threshhold for punting to the byte setter.  */
+#define TOO_SMALL(LEN) ((LEN) < BIGBLOCKSIZE)
+
 /**
  * The __memset() function copies the value of @p c (converted to an
  * unsigned char) into each of the first @p n characters of the object
@@ -31,12 +51,67 @@
  */
 void *__memset(void *s, int c, size_t n)
 {
-	unsigned char *p;
+	unsigned char *p = s;
+	unsigned char d = (unsigned char) c;
+	unsigned long buffer;
+	unsigned long *aligned_addr;
+
+	if (!TOO_SMALL(n))
+	{
+		/* Set bytes until the target address is aligned. */
+		while (UNALIGNED(p))
+		{
+			*p++ = d;
+			n--;
+		}
+
+		/* Broadcast the byte to all bytes of a long word. */
+		buffer = d;
+		buffer |= buffer << 8;
+		buffer |= buffer << 16;
+		if (LBLOCKSIZE > 4)
+			buffer |= (buffer << 16) << 16;
+
+		aligned_addr = (unsigned long *) p;
 
-	p = s;
+		/* Set 4X long words at a time if possible. */
+		while (n >= BIGBLOCKSIZE)
+		{
+			*aligned_addr++ = buffer;
+			*aligned_addr++ = buffer;
+			*aligned_addr++ = buffer;
+			*aligned_addr++ = buffer;
+			n -= BIGBLOCKSIZE;
+		}
+
+		/* Set one long word at a time if possible. */
+		while (n >= LBLOCKSIZE)
+		{
+			*aligned_addr++ = buffer;
+			n -= LBLOCKSIZE;
+		}
+
+		/* Pick up any residual with a byte setter. */
+		p = (unsigned char *) aligned_addr;
+	}
 
 	while (n-- > 0)
-		*p++ = c;
+		*p++ = d;
 
 	return (s);
 }
+
+#if !(defined(__unix64__) && defined(__x86_64__))
+
+/**
+ * The __memset_nt() function copies the value of @p c (converted to an
+ * unsigned char) into each of the first @p n characters of the object
+ * pointed to by @p s. This target has no cache-bypassing stores, so
+ * this is a regular fill.
+ */
+void *__memset_nt(void *s, int c, size_t n)
+{
+	return (__memset(s, c, n));
+}
+
+#endif
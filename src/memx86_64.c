@@ -0,0 +1,679 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stddef.h>
+
+#if defined(__unix64__) && defined(__x86_64__)
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+/**
+ * @brief Size (in bytes) above which copies and fills bypass caches.
+ *
+ * @details Targets may override this in their build makefiles. Zero
+ * disables non-temporal stores, except for explicit calls to
+ * __memcpy_nt() and __memset_nt().
+ */
+#ifndef __NT_THRESHOLD
+#define __NT_THRESHOLD (1 << 20)
+#endif
+
+/* Nonzero if LEN bytes should be handled with non-temporal stores.  */
+#if (__NT_THRESHOLD > 0)
+#define TOO_LARGE(LEN) ((LEN) >= (size_t)__NT_THRESHOLD)
+#else
+#define TOO_LARGE(LEN) 0
+#endif
+
+/*============================================================================*
+ * Generic Kernels                                                            *
+ *============================================================================*/
+
+/*
+ * Portable C kernels. These are the regular implementations found in
+ * memcpy.c, memset.c, memcmp.c and memchr.c, renamed on this target.
+ */
+extern void *__memcpy_generic(void *s1, const void *s2, size_t n);
+extern void *__memset_generic(void *s, int c, size_t n);
+extern int __memcmp_generic(const void *s1, const void *s2, size_t n);
+extern void *__memchr_generic(const void *s, int c, size_t n);
+
+/*============================================================================*
+ * SSE2 Kernels                                                               *
+ *============================================================================*/
+
+/* How many bytes are handled by a SSE2 vector.  */
+#define SSE2_BLOCKSIZE 16
+
+static void *memcpy_nt_sse2(void *s1, const void *s2, size_t n);
+static void *memset_nt_sse2(void *s, int c, size_t n);
+
+/**
+ * @brief Copies bytes in memory using SSE2 vectors.
+ */
+static void *memcpy_sse2(void *s1, const void *s2, size_t n)
+{
+	char *dst = s1;
+	const char *src = s2;
+	size_t head;
+
+	if (n < SSE2_BLOCKSIZE)
+		return (__memcpy_generic(s1, s2, n));
+	if (TOO_LARGE(n))
+		return (memcpy_nt_sse2(s1, s2, n));
+
+	/* Copy an unaligned head and then align the target area. */
+	head = SSE2_BLOCKSIZE - ((unsigned long)dst & (SSE2_BLOCKSIZE - 1));
+	_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+	dst += head; src += head; n -= head;
+
+	/* Copy 4X vectors at a time if possible. */
+	while (n >= (SSE2_BLOCKSIZE << 2))
+	{
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(src + 0));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(src + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(src + 48));
+		_mm_store_si128((__m128i *)(dst + 0), v0);
+		_mm_store_si128((__m128i *)(dst + 16), v1);
+		_mm_store_si128((__m128i *)(dst + 32), v2);
+		_mm_store_si128((__m128i *)(dst + 48), v3);
+		dst += 64; src += 64; n -= 64;
+	}
+
+	/* Copy one vector at a time if possible. */
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		_mm_store_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		dst += SSE2_BLOCKSIZE; src += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+	{
+		dst += n - SSE2_BLOCKSIZE; src += n - SSE2_BLOCKSIZE;
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+	}
+
+	return (s1);
+}
+
+/**
+ * @brief Sets bytes in memory using SSE2 vectors.
+ */
+static void *memset_sse2(void *s, int c, size_t n)
+{
+	char *p = s;
+	size_t head;
+	__m128i v;
+
+	if (n < SSE2_BLOCKSIZE)
+		return (__memset_generic(s, c, n));
+	if (TOO_LARGE(n))
+		return (memset_nt_sse2(s, c, n));
+
+	v = _mm_set1_epi8((char)c);
+
+	/* Set an unaligned head and then align the target area. */
+	head = SSE2_BLOCKSIZE - ((unsigned long)p & (SSE2_BLOCKSIZE - 1));
+	_mm_storeu_si128((__m128i *)p, v);
+	p += head; n -= head;
+
+	/* Set 4X vectors at a time if possible. */
+	while (n >= (SSE2_BLOCKSIZE << 2))
+	{
+		_mm_store_si128((__m128i *)(p + 0), v);
+		_mm_store_si128((__m128i *)(p + 16), v);
+		_mm_store_si128((__m128i *)(p + 32), v);
+		_mm_store_si128((__m128i *)(p + 48), v);
+		p += 64; n -= 64;
+	}
+
+	/* Set one vector at a time if possible. */
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		_mm_store_si128((__m128i *)p, v);
+		p += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+		_mm_storeu_si128((__m128i *)(p + n - SSE2_BLOCKSIZE), v);
+
+	return (s);
+}
+
+/**
+ * @brief Compares bytes in memory using SSE2 vectors.
+ */
+static int memcmp_sse2(const void *s1, const void *s2, size_t n)
+{
+	const unsigned char *p1 = s1;
+	const unsigned char *p2 = s2;
+	unsigned mask;
+
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)p1),
+			_mm_loadu_si128((const __m128i *)p2)
+		));
+
+		/* Found a mismatch. */
+		if (mask != 0xffff)
+		{
+			mask = __builtin_ctz(~mask);
+			return (p1[mask] - p2[mask]);
+		}
+
+		p1 += SSE2_BLOCKSIZE; p2 += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	return (__memcmp_generic(p1, p2, n));
+}
+
+/**
+ * @brief Finds a byte in memory using SSE2 vectors.
+ */
+static void *memchr_sse2(const void *s, int c, size_t n)
+{
+	const unsigned char *p = s;
+	unsigned mask;
+	__m128i v;
+
+	v = _mm_set1_epi8((char)c);
+
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)p), v
+		));
+
+		/* Found. */
+		if (mask != 0)
+			return ((void *)(p + __builtin_ctz(mask)));
+
+		p += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	return (__memchr_generic(p, c, n));
+}
+
+/*============================================================================*
+ * Non-Temporal Kernels                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Copies bytes in memory using SSE2 non-temporal stores.
+ */
+static void *memcpy_nt_sse2(void *s1, const void *s2, size_t n)
+{
+	char *dst = s1;
+	const char *src = s2;
+	size_t head;
+
+	if (n < (SSE2_BLOCKSIZE << 2))
+		return (__memcpy_generic(s1, s2, n));
+
+	/* Copy an unaligned head and then align the target area. */
+	head = SSE2_BLOCKSIZE - ((unsigned long)dst & (SSE2_BLOCKSIZE - 1));
+	_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+	dst += head; src += head; n -= head;
+
+	/* Stream 4X vectors at a time if possible. */
+	while (n >= (SSE2_BLOCKSIZE << 2))
+	{
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(src + 0));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(src + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(src + 48));
+		_mm_stream_si128((__m128i *)(dst + 0), v0);
+		_mm_stream_si128((__m128i *)(dst + 16), v1);
+		_mm_stream_si128((__m128i *)(dst + 32), v2);
+		_mm_stream_si128((__m128i *)(dst + 48), v3);
+		dst += 64; src += 64; n -= 64;
+	}
+
+	/* Stream one vector at a time if possible. */
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		_mm_stream_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		dst += SSE2_BLOCKSIZE; src += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	/* Order non-temporal stores before any later store. */
+	_mm_sfence();
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+	{
+		dst += n - SSE2_BLOCKSIZE; src += n - SSE2_BLOCKSIZE;
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+	}
+
+	return (s1);
+}
+
+/**
+ * @brief Sets bytes in memory using SSE2 non-temporal stores.
+ */
+static void *memset_nt_sse2(void *s, int c, size_t n)
+{
+	char *p = s;
+	size_t head;
+	__m128i v;
+
+	if (n < (SSE2_BLOCKSIZE << 2))
+		return (__memset_generic(s, c, n));
+
+	v = _mm_set1_epi8((char)c);
+
+	/* Set an unaligned head and then align the target area. */
+	head = SSE2_BLOCKSIZE - ((unsigned long)p & (SSE2_BLOCKSIZE - 1));
+	_mm_storeu_si128((__m128i *)p, v);
+	p += head; n -= head;
+
+	/* Stream 4X vectors at a time if possible. */
+	while (n >= (SSE2_BLOCKSIZE << 2))
+	{
+		_mm_stream_si128((__m128i *)(p + 0), v);
+		_mm_stream_si128((__m128i *)(p + 16), v);
+		_mm_stream_si128((__m128i *)(p + 32), v);
+		_mm_stream_si128((__m128i *)(p + 48), v);
+		p += 64; n -= 64;
+	}
+
+	/* Stream one vector at a time if possible. */
+	while (n >= SSE2_BLOCKSIZE)
+	{
+		_mm_stream_si128((__m128i *)p, v);
+		p += SSE2_BLOCKSIZE; n -= SSE2_BLOCKSIZE;
+	}
+
+	/* Order non-temporal stores before any later store. */
+	_mm_sfence();
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+		_mm_storeu_si128((__m128i *)(p + n - SSE2_BLOCKSIZE), v);
+
+	return (s);
+}
+
+/*============================================================================*
+ * AVX2 Kernels                                                               *
+ *============================================================================*/
+
+/* How many bytes are handled by an AVX2 vector.  */
+#define AVX2_BLOCKSIZE 32
+
+/* Compiles a function for AVX2-capable processors.  */
+#define AVX2 __attribute__((target("avx2")))
+
+/**
+ * @brief Copies bytes in memory using AVX2 vectors.
+ */
+AVX2 static void *memcpy_avx2(void *s1, const void *s2, size_t n)
+{
+	char *dst = s1;
+	const char *src = s2;
+	size_t head;
+
+	if ((n < AVX2_BLOCKSIZE) || TOO_LARGE(n))
+		return (memcpy_sse2(s1, s2, n));
+
+	/* Copy an unaligned head and then align the target area. */
+	head = AVX2_BLOCKSIZE - ((unsigned long)dst & (AVX2_BLOCKSIZE - 1));
+	_mm256_storeu_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+	dst += head; src += head; n -= head;
+
+	/* Copy 4X vectors at a time if possible. */
+	while (n >= (AVX2_BLOCKSIZE << 2))
+	{
+		__m256i v0 = _mm256_loadu_si256((const __m256i *)(src + 0));
+		__m256i v1 = _mm256_loadu_si256((const __m256i *)(src + 32));
+		__m256i v2 = _mm256_loadu_si256((const __m256i *)(src + 64));
+		__m256i v3 = _mm256_loadu_si256((const __m256i *)(src + 96));
+		_mm256_store_si256((__m256i *)(dst + 0), v0);
+		_mm256_store_si256((__m256i *)(dst + 32), v1);
+		_mm256_store_si256((__m256i *)(dst + 64), v2);
+		_mm256_store_si256((__m256i *)(dst + 96), v3);
+		dst += 128; src += 128; n -= 128;
+	}
+
+	/* Copy one vector at a time if possible. */
+	while (n >= AVX2_BLOCKSIZE)
+	{
+		_mm256_store_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+		dst += AVX2_BLOCKSIZE; src += AVX2_BLOCKSIZE; n -= AVX2_BLOCKSIZE;
+	}
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+	{
+		dst += n - AVX2_BLOCKSIZE; src += n - AVX2_BLOCKSIZE;
+		_mm256_storeu_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+	}
+
+	return (s1);
+}
+
+/**
+ * @brief Sets bytes in memory using AVX2 vectors.
+ */
+AVX2 static void *memset_avx2(void *s, int c, size_t n)
+{
+	char *p = s;
+	size_t head;
+	__m256i v;
+
+	if ((n < AVX2_BLOCKSIZE) || TOO_LARGE(n))
+		return (memset_sse2(s, c, n));
+
+	v = _mm256_set1_epi8((char)c);
+
+	/* Set an unaligned head and then align the target area. */
+	head = AVX2_BLOCKSIZE - ((unsigned long)p & (AVX2_BLOCKSIZE - 1));
+	_mm256_storeu_si256((__m256i *)p, v);
+	p += head; n -= head;
+
+	/* Set 4X vectors at a time if possible. */
+	while (n >= (AVX2_BLOCKSIZE << 2))
+	{
+		_mm256_store_si256((__m256i *)(p + 0), v);
+		_mm256_store_si256((__m256i *)(p + 32), v);
+		_mm256_store_si256((__m256i *)(p + 64), v);
+		_mm256_store_si256((__m256i *)(p + 96), v);
+		p += 128; n -= 128;
+	}
+
+	/* Set one vector at a time if possible. */
+	while (n >= AVX2_BLOCKSIZE)
+	{
+		_mm256_store_si256((__m256i *)p, v);
+		p += AVX2_BLOCKSIZE; n -= AVX2_BLOCKSIZE;
+	}
+
+	/* Pick up any residual with an overlapping vector. */
+	if (n > 0)
+		_mm256_storeu_si256((__m256i *)(p + n - AVX2_BLOCKSIZE), v);
+
+	return (s);
+}
+
+/**
+ * @brief Compares bytes in memory using AVX2 vectors.
+ */
+AVX2 static int memcmp_avx2(const void *s1, const void *s2, size_t n)
+{
+	const unsigned char *p1 = s1;
+	const unsigned char *p2 = s2;
+	unsigned mask;
+
+	while (n >= AVX2_BLOCKSIZE)
+	{
+		mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+			_mm256_loadu_si256((const __m256i *)p1),
+			_mm256_loadu_si256((const __m256i *)p2)
+		));
+
+		/* Found a mismatch. */
+		if (mask != 0xffffffff)
+		{
+			mask = __builtin_ctz(~mask);
+			return (p1[mask] - p2[mask]);
+		}
+
+		p1 += AVX2_BLOCKSIZE; p2 += AVX2_BLOCKSIZE; n -= AVX2_BLOCKSIZE;
+	}
+
+	return (memcmp_sse2(p1, p2, n));
+}
+
+/**
+ * @brief Finds a byte in memory using AVX2 vectors.
+ */
+AVX2 static void *memchr_avx2(const void *s, int c, size_t n)
+{
+	const unsigned char *p = s;
+	unsigned mask;
+	__m256i v;
+
+	v = _mm256_set1_epi8((char)c);
+
+	while (n >= AVX2_BLOCKSIZE)
+	{
+		mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+			_mm256_loadu_si256((const __m256i *)p), v
+		));
+
+		/* Found. */
+		if (mask != 0)
+			return ((void *)(p + __builtin_ctz(mask)));
+
+		p += AVX2_BLOCKSIZE; n -= AVX2_BLOCKSIZE;
+	}
+
+	return (memchr_sse2(p, c, n));
+}
+
+/*============================================================================*
+ * Dispatcher                                                                 *
+ *============================================================================*/
+
+static void *memcpy_resolve(void *s1, const void *s2, size_t n);
+static void *memset_resolve(void *s, int c, size_t n);
+static int memcmp_resolve(const void *s1, const void *s2, size_t n);
+static void *memchr_resolve(const void *s, int c, size_t n);
+
+/**
+ * @brief Memory kernels.
+ *
+ * @details Until the processor is probed, entries point to resolvers
+ * that fill up the table and then forward the call.
+ */
+static struct
+{
+	void *(*memcpy)(void *, const void *, size_t);
+	void *(*memset)(void *, int, size_t);
+	int (*memcmp)(const void *, const void *, size_t);
+	void *(*memchr)(const void *, int, size_t);
+} memops = {
+	memcpy_resolve,
+	memset_resolve,
+	memcmp_resolve,
+	memchr_resolve
+};
+
+/*
+ * Entries of the table may be stored by several threads at once, on
+ * their first calls. They are accessed atomically, so that this is not
+ * a data race. Relaxed ordering suffices, because they point to code
+ * and publish no data.
+ */
+#define MEMOPS_LOAD(F)     __atomic_load_n(&memops.F, __ATOMIC_RELAXED)
+#define MEMOPS_STORE(F, K) __atomic_store_n(&memops.F, K, __ATOMIC_RELAXED)
+
+/**
+ * @brief Asserts whether the processor and the OS support AVX2.
+ *
+ * @returns Non-zero if AVX2 is supported and zero otherwise.
+ */
+static int has_avx2(void)
+{
+	unsigned eax, ebx, ecx, edx;
+	unsigned xcr0;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return (0);
+
+	/* AVX state must be enabled in XCR0 by the OS. */
+	if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+		return (0);
+	__asm__ __volatile__ ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+	if ((xcr0 & 0x6) != 0x6)
+		return (0);
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return (0);
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+	return (ebx & bit_AVX2);
+}
+
+/**
+ * @brief Probes the processor and selects the best memory kernels.
+ *
+ * @details SSE2 is part of the x86-64 baseline, so it is always used
+ * when AVX2 is not available. Concurrent probes are harmless, because
+ * all of them atomically store the same values.
+ */
+static void memops_init(void)
+{
+	if (has_avx2())
+	{
+		MEMOPS_STORE(memcpy, memcpy_avx2);
+		MEMOPS_STORE(memset, memset_avx2);
+		MEMOPS_STORE(memcmp, memcmp_avx2);
+		MEMOPS_STORE(memchr, memchr_avx2);
+	}
+	else
+	{
+		MEMOPS_STORE(memcpy, memcpy_sse2);
+		MEMOPS_STORE(memset, memset_sse2);
+		MEMOPS_STORE(memcmp, memcmp_sse2);
+		MEMOPS_STORE(memchr, memchr_sse2);
+	}
+}
+
+/**
+ * @brief Resolves __memcpy() on its first call.
+ */
+static void *memcpy_resolve(void *s1, const void *s2, size_t n)
+{
+	memops_init();
+	return (MEMOPS_LOAD(memcpy)(s1, s2, n));
+}
+
+/**
+ * @brief Resolves __memset() on its first call.
+ */
+static void *memset_resolve(void *s, int c, size_t n)
+{
+	memops_init();
+	return (MEMOPS_LOAD(memset)(s, c, n));
+}
+
+/**
+ * @brief Resolves __memcmp() on its first call.
+ */
+static int memcmp_resolve(const void *s1, const void *s2, size_t n)
+{
+	memops_init();
+	return (MEMOPS_LOAD(memcmp)(s1, s2, n));
+}
+
+/**
+ * @brief Resolves __memchr() on its first call.
+ */
+static void *memchr_resolve(const void *s, int c, size_t n)
+{
+	memops_init();
+	return (MEMOPS_LOAD(memchr)(s, c, n));
+}
+
+/*============================================================================*
+ * Public Interface                                                           *
+ *============================================================================*/
+
+/**
+ * The __memcpy() function copies @p n characters from the object
+ * pointed to by @p s2 into the object pointed to by @p s1, using the
+ * best kernel for the underlying processor.
+ */
+void *__memcpy(void *s1, const void *s2, size_t n)
+{
+	return (MEMOPS_LOAD(memcpy)(s1, s2, n));
+}
+
+/**
+ * The __memset() function copies the value of @p c (converted to an
+ * unsigned char) into each of the first @p n characters of the object
+ * pointed to by @p s, using the best kernel for the underlying
+ * processor.
+ */
+void *__memset(void *s, int c, size_t n)
+{
+	return (MEMOPS_LOAD(memset)(s, c, n));
+}
+
+/**
+ * The __memcpy_nt() function copies @p n characters from the object
+ * pointed to by @p s2 into the object pointed to by @p s1, using
+ * non-temporal stores that bypass caches.
+ */
+void *__memcpy_nt(void *s1, const void *s2, size_t n)
+{
+	return (memcpy_nt_sse2(s1, s2, n));
+}
+
+/**
+ * The __memset_nt() function copies the value of @p c (converted to an
+ * unsigned char) into each of the first @p n characters of the object
+ * pointed to by @p s, using non-temporal stores that bypass caches.
+ */
+void *__memset_nt(void *s, int c, size_t n)
+{
+	return (memset_nt_sse2(s, c, n));
+}
+
+/**
+ * The __memcmp() function compares the first @p n bytes of the objects
+ * pointed to by @p s1 and @p s2, using the best kernel for the
+ * underlying processor.
+ */
+int __memcmp(const void *s1, const void *s2, size_t n)
+{
+	return (MEMOPS_LOAD(memcmp)(s1, s2, n));
+}
+
+/**
+ * The __memchr() function locates the first occurrence of @p c
+ * (converted to an unsigned char) in the first @p n bytes of the object
+ * pointed to by @p s, using the best kernel for the underlying
+ * processor.
+ */
+void *__memchr(const void *s, int c, size_t n)
+{
+	return (MEMOPS_LOAD(memchr)(s, c, n));
+}
+
+#else
+
+/* Make ISO C compilers happy. */
+extern int __memx86_64_dummy;
+
+#endif /* __unix64__ && __x86_64__ */
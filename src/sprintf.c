@@ -41,8 +41,7 @@ int __sprintf(char *str, const char *fmt, ...)
 	/* Convert to raw string. */
 	va_start(args, fmt);
 	len = __vsnprintf(str, TRUNCATE_SIZE + 1, fmt, args);
-	str[len + 1] = '\0';
 	va_end(args);
 
-	return (len);
+	return ((len > TRUNCATE_SIZE) ? TRUNCATE_SIZE : len);
 }
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -31,15 +32,37 @@
  */
 char *__strchr(const char *s, int c)
 {
-	/* Scan string. */
-	while (*s != '\0')
+	unsigned char ch = (unsigned char) c;
+	unsigned long mask;
+	const unsigned long *aligned_s;
+
+	/* Scan bytes until aligned. */
+	for (/* noop */; WORD_UNALIGNED(s); s++)
 	{
-		/* Found. */
-		if (*s == c)
+		if (*(const unsigned char *)s == ch)
 			return ((char *) s);
+		if (*s == '\0')
+			return (NULL);
+	}
+
+	/* Broadcast the target byte to all bytes of a long word. */
+	mask = ch * WORD_ONES;
 
-		s++;
+	/*
+	 * Skip long words that have neither a null byte nor the target
+	 * byte. The latter turns into a null byte when XOR-ed with mask.
+	 */
+	aligned_s = (const unsigned long *)s;
+	while (!WORD_HAS_NULL(*aligned_s) && !WORD_HAS_NULL(*aligned_s ^ mask))
+		aligned_s++;
+
+	/* Find the byte within the long word. */
+	for (s = (const char *)aligned_s; *s != '\0'; s++)
+	{
+		/* Found. */
+		if (*(const unsigned char *)s == ch)
+			return ((char *) s);
 	}
 
-	return ((c == '\0') ? (char *) s : NULL);
+	return ((ch == '\0') ? (char *) s : NULL);
 }
@@ -55,6 +55,7 @@
  * SUCH DAMAGE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -64,24 +65,19 @@
  */
 size_t __strcspn(const char *s1, const char *s2)
 {
-	char c, sc;
-	const char *p, *spanp;
+	const unsigned char *p;
+	bitmap_t set[BITMAP_NWORDS(256)] = { 0 };
 
 	/*
-	 * Stop as soon as we find any character from s2.  Note that there
-	 * must be a NULL in s2; it suffices to stop when we find that, too.
+	 * Build set of rejected characters. The null character is
+	 * also in the set, so that we stop at the end of s1, too.
 	 */
-	for (p = s1; /* noop */; /* noop */)
-	{
-		c = *p++;
-		spanp = s2;
+	bitmap_set(set, '\0');
+	for (p = (const unsigned char *)s2; *p != '\0'; p++)
+		bitmap_set(set, *p);
 
-		do {
-			if ((sc = *spanp++) == c)
-				return (p - 1 - s1);
-		} while (sc != '\0');
-	}
+	for (p = (const unsigned char *)s1; !bitmap_test(set, *p); p++)
+		/* No operation. */;
 
-	/* Not reached. */
-	return (0);
+	return (p - (const unsigned char *)s1);
 }
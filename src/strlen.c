@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -31,9 +32,22 @@
 size_t __strlen(const char *str)
 {
 	const char *p;
+	const unsigned long *aligned_p;
 
-	/* Count the number of characters. */
-	for (p = str; *p != '\0'; p++)
+	/* Scan bytes until aligned. */
+	for (p = str; WORD_UNALIGNED(p); p++)
+	{
+		if (*p == '\0')
+			return (p - str);
+	}
+
+	/* Skip long words that have no null byte. */
+	aligned_p = (const unsigned long *)p;
+	while (!WORD_HAS_NULL(*aligned_p))
+		aligned_p++;
+
+	/* Find the null byte within the long word. */
+	for (p = (const char *)aligned_p; *p != '\0'; p++)
 		/* No operation.*/;
 
 	return (p - str);
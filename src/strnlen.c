@@ -51,8 +51,12 @@
  */
 
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
+/* How many bytes are scanned each iteration of the word scan loop.  */
+#define LBLOCKSIZE (sizeof (long))
+
 /**
  * The strnlen() function computes the length of the fixed size string
  * pointed to by @p s.
@@ -60,8 +64,25 @@
 size_t __strnlen(const char *s, size_t maxlen)
 {
 	size_t len;
+	const unsigned long *aligned_s;
+
+	/* Scan bytes until aligned. */
+	for (len = 0; (len < maxlen) && WORD_UNALIGNED(s); len++, s++)
+	{
+		if (!*s)
+			return (len);
+	}
+
+	/* Skip long words that have no null byte. */
+	aligned_s = (const unsigned long *)s;
+	while ((maxlen - len) >= LBLOCKSIZE && !WORD_HAS_NULL(*aligned_s))
+	{
+		aligned_s++;
+		len += LBLOCKSIZE;
+	}
 
-	for (len = 0; len < maxlen; len++, s++)
+	/* Pick up any residual with a byte scanner. */
+	for (s = (const char *)aligned_s; len < maxlen; len++, s++)
 	{
 		if (!*s)
 			break;
@@ -55,6 +55,7 @@
  * SUCH DAMAGE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -64,29 +65,7 @@
  */
 char *__strpbrk(const char *s1, const char *s2)
 {
-	const char *c;
+	s1 += __strcspn(s1, s2);
 
-	c = s2;
-
-	if (*s1 == '\0')
-		return ((char *) NULL);
-
-	while (*s1 != '\0')
-	{
-		for (c = s2; *c != '\0'; c++)
-		{
-			if (*s1 == *c)
-				break;
-		}
-
-		if (*c != '\0')
-			break;
-
-		s1++;
-	}
-
-	if (*c == '\0')
-		s1 = NULL;
-
-	return ((char *) s1);
+	return ((*s1 != '\0') ? (char *) s1 : NULL);
 }
@@ -55,6 +55,7 @@
  * SUCH DAMAGE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -64,23 +65,16 @@
  */
 size_t __strspn(const char *s1, const char *s2)
 {
-	const char *s;
-	const char *c;
+	const unsigned char *p;
+	bitmap_t set[BITMAP_NWORDS(256)] = { 0 };
 
-	s = s1;
+	/* Build set of accepted characters. */
+	for (p = (const unsigned char *)s2; *p != '\0'; p++)
+		bitmap_set(set, *p);
 
-	while (*s1 != '\0')
-	{
-		for (c = s2; *c != '\0'; c++)
-		{
-			if (*s1 == *c)
-				break;
-		}
+	/* The null character is never in the set. */
+	for (p = (const unsigned char *)s1; bitmap_test(set, *p); p++)
+		/* No operation. */;
 
-		if (*c == '\0')
-			break;
-		s1++;
-	}
-
-	return (s1 - s);
+	return (p - (const unsigned char *)s1);
 }
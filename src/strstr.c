@@ -55,6 +55,7 @@
  * SUCH DAMAGE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stddef.h>
 
 /**
@@ -64,30 +65,5 @@
  */
 char *__strstr(const char *s1, const char *s2)
 {
-	if (*s1 == '\0')
-	{
-		if (*s2 != '\0')
-			return ((char *) NULL);
-		return ((char *) s1);
-	}
-
-	while (*s1 != '\0')
-	{
-		size_t i;
-
-		i = 0;
-
-		while (1)
-		{
-			if (s2[i] == '\0')
-				return ((char *) s1);
-
-			if (s2[i] != s1[i])
-				break;
-			i++;
-		}
-		s1++;
-	}
-
-	return ((char *) NULL);
+	return (__memmem(s1, __strlen(s1), s2, __strlen(s2)));
 }
@@ -54,3 +54,36 @@ unsigned long __umodsi3(unsigned long a, unsigned long b)
 	return __udivmodsi4(a, b, 1);
 }
 
+/**
+ * @brief Divides two unsigned long long integers.
+ *
+ * @param a First operand.
+ * @param b Second operand.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The result of @p a divided by @p b.
+ */
+unsigned long long __udivdi3(unsigned long long a, unsigned long long b)
+{
+	return __udivmoddi4(a, b, NULL);
+}
+
+/**
+ * @brief Module between two unsigned long long integers.
+ *
+ * @param a First operand.
+ * @param b Second operand.
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The result of @p a module by @p b.
+ */
+unsigned long long __umoddi3(unsigned long long a, unsigned long long b)
+{
+	unsigned long long rem;
+
+	__udivmoddi4(a, b, &rem);
+
+	return rem;
+}
@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/barelib.h>
+#include <posix/stddef.h>
+
+/**
+ * @brief Divides two unsigned long long integers.
+ *
+ * @param num Dividend.
+ * @param den Divisor.
+ * @param rem Location to store the remainder (may be NULL).
+ *
+ * Source: https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcc2.c
+ *
+ * @returns The result of @p num divided by @p den.
+ */
+unsigned long long __udivmoddi4(unsigned long long num, unsigned long long den, unsigned long long *rem)
+{
+	unsigned long long bit;
+	unsigned long long res = 0;
+
+	/* Align the divisor with the dividend in a single step. */
+	if ((den != 0) && (den <= num))
+	{
+		int shift = __builtin_clzll(den) - __builtin_clzll(num);
+
+		den <<= shift;
+		bit = 1ULL << shift;
+
+		while (bit)
+		{
+			if (num >= den)
+			{
+				num -= den;
+				res |= bit;
+			}
+
+			bit >>= 1;
+			den >>= 1;
+		}
+	}
+
+	if (rem != NULL)
+		*rem = num;
+
+	return (res);
+}
@@ -22,6 +22,8 @@
  * SOFTWARE.
  */
 
+#include <nanvix/barelib.h>
+
 /**
  * @brief Divide between two unsigned long integers.
  *
@@ -34,25 +36,28 @@
  */
 unsigned long __udivmodsi4(unsigned long num, unsigned long den, int modwanted)
 {
-	unsigned long bit = 1;
+	unsigned long bit;
 	unsigned long res = 0;
 
-	while (den < num && bit && !(den & (1L << 31)))
+	/* Align the divisor with the dividend in a single step. */
+	if ((den != 0) && (den <= num))
 	{
-		den <<= 1;
-		bit <<= 1;
-	}
+		int shift = __builtin_clzl(den) - __builtin_clzl(num);
 
-	while (bit)
-	{
-		if (num >= den)
+		den <<= shift;
+		bit = 1UL << shift;
+
+		while (bit)
 		{
-			num -= den;
-			res |= bit;
-		}
+			if (num >= den)
+			{
+				num -= den;
+				res |= bit;
+			}
 
-		bit >>= 1;
-		den >>= 1;
+			bit >>= 1;
+			den >>= 1;
+		}
 	}
 
 	if (modwanted)
@@ -60,4 +65,3 @@ unsigned long __udivmodsi4(unsigned long num, unsigned long den, int modwanted)
 
 	return res;
 }
-
@@ -22,307 +22,1243 @@
  * SOFTWARE.
  */
 
+#include <nanvix/barelib.h>
 #include <posix/stdarg.h>
 #include <posix/stddef.h>
+#include <posix/stdint.h>
 
-#ifndef __qemu_riscv32__
 typedef unsigned long long UNSIGNED_T;
+
+/**
+ * @brief Decimal digit pairs, from "00" to "99".
+ */
+static const char digit_pairs[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/**
+ * @brief Hexadecimal digits.
+ */
+static const char hex_digits[17] = "0123456789abcdef";
+
+/**
+ * @brief Uppercase hexadecimal digits.
+ */
+static const char hex_digits_upper[17] = "0123456789ABCDEF";
+
+/**
+ * @brief Powers of ten that fit in 64 bits.
+ */
+static const UNSIGNED_T powers_of_ten[20] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+/**
+ * @brief Divides an integer by a hundred.
+ *
+ * @details Without a hardware divider, multiplies by the reciprocal of
+ * a hundred in 0.37 fixed point, which gives the exact quotient for any
+ * 32-bit integer.
+ *
+ * @param num Dividend.
+ *
+ * @returns The result of @p num divided by a hundred.
+ */
+static inline unsigned div100(unsigned num)
+{
+#if (__HAS_HW_DIVISION)
+	return (num / 100);
 #else
-typedef unsigned UNSIGNED_T;
+	return ((unsigned)(((UNSIGNED_T)num * 0x51eb851fULL) >> 37));
 #endif
+}
 
 /**
- * @brief Converts an integer to a string.
+ * @brief Divides a 64 bit integer by a hundred.
  *
- * @param str  Output string.
- * @param num  Number to be converted.
- * @param base Base to use.
+ * @details Without a hardware divider, computes (num/4)*(2^66/25)/2^66
+ * with a fixed-point reciprocal, which gives the exact quotient for any
+ * 64-bit integer. The high half of the 128-bit product is assembled
+ * from 32-bit partial products.
  *
- * @returns The length of the output string.
+ * @param num Dividend.
+ *
+ * @returns The result of @p num divided by a hundred.
  */
-static int itoa(char *str, unsigned num, int base)
+static inline UNSIGNED_T div100_64(UNSIGNED_T num)
 {
-	char *b = str;
-	char *p, *p1, *p2;
-	unsigned divisor;
-
 #if (__HAS_HW_DIVISION)
+	return (num / 100);
+#else
+	const UNSIGNED_T mlo = 0x5c28f5c3ULL;
+	const UNSIGNED_T mhi = 0x28f5c28fULL;
+	UNSIGNED_T lo, hi, hilo, cross;
+
+	num >>= 2;
+	lo = (unsigned)num;
+	hi = num >> 32;
+	hilo = hi*mlo;
+	cross = ((lo*mlo) >> 32) + (unsigned)hilo + lo*mhi;
+
+	return (((hilo >> 32) + (cross >> 32) + hi*mhi) >> 2);
+#endif
+}
 
-	divisor = 10;
+/**
+ * @brief Counts number of decimal digits a number has.
+ *
+ * @details Estimates log10 from the position of the most significant
+ * bit (log10(2) ~ 1233/4096) and fixes the estimate with a single
+ * comparison against a power of ten.
+ *
+ * @param num Number to have digits counted.
+ *
+ * @returns Number of digits of @p num (one for zero).
+ */
+static unsigned count_digits(UNSIGNED_T num)
+{
+	unsigned t;
+
+	num |= 1;
+	t = ((64 - __builtin_clzll(num))*1233) >> 12;
+
+	return (t + (num >= powers_of_ten[t]));
+}
+
+/**
+ * @brief Converts an unsigned integer to a decimal string.
+ *
+ * @details Digits are emitted two at a time, from the least significant
+ * one, straight into their final positions. Large numbers are reduced
+ * with 64-bit arithmetic only until they fit in 32 bits.
+ *
+ * @param str     Output string.
+ * @param num     Number to be converted.
+ * @param ndigits Number of digits of @p num (see count_digits()).
+ *
+ * @returns The length of the output string.
+ */
+static int utoa(char *str, UNSIGNED_T num, unsigned ndigits)
+{
+	char *p = str + ndigits;
+	unsigned num32;
+	unsigned r;
 
-	if (base == 'x')
+	while (num > 0xffffffffULL)
 	{
-		*b++ = '0'; *b++ = 'x';
-		divisor = 16;
+		UNSIGNED_T q = div100_64(num);
+		r = (unsigned)(num - q*100);
+		num = q;
+		p -= 2;
+		p[0] = digit_pairs[2*r];
+		p[1] = digit_pairs[2*r + 1];
 	}
 
-	p = b;
+	num32 = (unsigned)num;
 
-	/* Convert number. */
-	do
+	while (num32 >= 100)
 	{
-		unsigned remainder;
+		unsigned q = div100(num32);
+		r = num32 - q*100;
+		num32 = q;
+		p -= 2;
+		p[0] = digit_pairs[2*r];
+		p[1] = digit_pairs[2*r + 1];
+	}
 
-#ifdef __GLIBC_BUG__
-		remainder = (divisor == 10 ? (num % 10) : (num % 16));
-#else
-		remainder = num % divisor;
-#endif
+	if (num32 >= 10)
+	{
+		p -= 2;
+		p[0] = digit_pairs[2*num32];
+		p[1] = digit_pairs[2*num32 + 1];
+	}
+	else
+		*--p = '0' + num32;
 
-		*p++ = (remainder < 10) ?
-			remainder + '0' : remainder + 'a' - 10;
+	return (ndigits);
+}
 
-#ifdef __GLIBC_BUG__
-	} while ((divisor == 10 ? (num /= 10) : (num /= 16)));
-#else
-	} while (num /= divisor);
-#endif
+/**
+ * @brief Converts an unsigned integer to a string in a power-of-two base.
+ *
+ * @param str    Output string.
+ * @param num    Number to be converted.
+ * @param shift  Bits per digit (3 for octal, 4 for hexadecimal).
+ * @param digits Digits of the target base.
+ *
+ * @returns The length of the output string.
+ */
+static int btoa(char *str, UNSIGNED_T num, unsigned shift, const char *digits)
+{
+	char *p;
+	UNSIGNED_T t;
+	int ndigits = 1;
+	unsigned mask = (1U << shift) - 1;
 
-#else
+	for (t = num >> shift; t != 0; t >>= shift)
+		ndigits++;
+
+	for (p = str + ndigits; p > str; num >>= shift)
+		*--p = digits[num & mask];
+
+	return (ndigits);
+}
+
+/**
+ * @name Flags of a Conversion Specification
+ */
+/**@{*/
+#define FMT_LEFT   (1 << 0) /**< Left-justify within the field.    */
+#define FMT_ZERO   (1 << 1) /**< Pad with leading zeros.           */
+#define FMT_PLUS   (1 << 2) /**< Always print a sign.              */
+#define FMT_SPACE  (1 << 3) /**< Print a space in place of a plus. */
+#define FMT_ALT    (1 << 4) /**< Alternate form.                   */
+#define FMT_LEGACY (1 << 5) /**< Legacy 0x-prefixed hex form.      */
+/**@}*/
 
-	((void) base);
+/**
+ * @name Field Width and Precision Markers
+ */
+/**@{*/
+#define FMT_NONE (-1) /**< Not given.                       */
+#define FMT_STAR (-2) /**< Taken from the arguments list.   */
+/**@}*/
+
+/**
+ * @name Length Modifiers
+ */
+/**@{*/
+#define FMT_LEN_NONE 0 /**< No modifier. */
+#define FMT_LEN_HH   1 /**< hh          */
+#define FMT_LEN_H    2 /**< h           */
+#define FMT_LEN_L    3 /**< l           */
+#define FMT_LEN_LL   4 /**< ll          */
+#define FMT_LEN_Z    5 /**< z           */
+#define FMT_LEN_Q    6 /**< L (legacy)  */
+/**@}*/
 
-	*b++ = '0'; *b++ = 'x';
-	divisor = 16;
+/**
+ * @name Kinds of Arguments
+ */
+/**@{*/
+#define FMT_ARG_NONE  0 /**< No argument.               */
+#define FMT_ARG_INT   1 /**< int.                       */
+#define FMT_ARG_UINT  2 /**< unsigned int.              */
+#define FMT_ARG_LONG  3 /**< long (and signed size_t).  */
+#define FMT_ARG_ULONG 4 /**< unsigned long.             */
+#define FMT_ARG_SIZE  5 /**< size_t.                    */
+#define FMT_ARG_LLONG 6 /**< 64-bit integer.            */
+#define FMT_ARG_PTR   7 /**< Pointer.                   */
+/**@}*/
 
-	p = b;
+/**
+ * @brief Conversion specification.
+ */
+struct fmt_spec
+{
+	char conv;             /**< Conversion (zero if invalid). */
+	unsigned char flags;   /**< Flags.                        */
+	unsigned char length;  /**< Length modifier.              */
+	unsigned char arg;     /**< Kind of argument.             */
+	int width;             /**< Minimum field width.          */
+	int precision;         /**< Precision.                    */
+};
 
-	/* Convert number. */
-	do
+/**
+ * @brief Parses a conversion specification.
+ *
+ * @details Besides C99 specifications, this accepts the legacy forms
+ * of barelib. A bare %l prints an unsigned long, and %x and %lx, when
+ * given without flags, width or precision, print 0x and as many hex
+ * digits as the argument has nibbles. The l modifier always denotes a
+ * long, as in C99, so it reads the same argument whatever the flags.
+ * The legacy L modifier denotes a 64-bit integer on every target: a
+ * bare %L prints a 64-bit unsigned integer and a plain %Lx prints 0x
+ * and 16 hex digits.
+ *
+ * @param fmt  Specification, right after the percent sign.
+ * @param spec Store location for the parsed specification.
+ *
+ * @returns A pointer to the first character past the specification.
+ */
+static const char *fmt_parse(const char *fmt, struct fmt_spec *spec)
+{
+	int plain;
+
+	spec->flags = 0;
+	spec->length = FMT_LEN_NONE;
+	spec->width = FMT_NONE;
+	spec->precision = FMT_NONE;
+
+	/* Flags. */
+	for (/* noop */; /* noop */; fmt++)
 	{
-		unsigned remainder = num & 0xf;
+		if (*fmt == '-')
+			spec->flags |= FMT_LEFT;
+		else if (*fmt == '0')
+			spec->flags |= FMT_ZERO;
+		else if (*fmt == '+')
+			spec->flags |= FMT_PLUS;
+		else if (*fmt == ' ')
+			spec->flags |= FMT_SPACE;
+		else if (*fmt == '#')
+			spec->flags |= FMT_ALT;
+		else
+			break;
+	}
 
-		*p++ = (remainder < 10) ?
-			remainder + '0' : remainder + 'a' - 10;
-	} while ((num  = (num >> 4)));
+	/* Field width. */
+	if (*fmt == '*')
+	{
+		spec->width = FMT_STAR;
+		fmt++;
+	}
+	else if (*fmt >= '0' && *fmt <= '9')
+	{
+		for (spec->width = 0; *fmt >= '0' && *fmt <= '9'; fmt++)
+			spec->width = spec->width*10 + (*fmt - '0');
+	}
 
-#endif
+	/* Precision. */
+	if (*fmt == '.')
+	{
+		if (*(++fmt) == '*')
+		{
+			spec->precision = FMT_STAR;
+			fmt++;
+		}
+		else
+		{
+			for (spec->precision = 0; *fmt >= '0' && *fmt <= '9'; fmt++)
+				spec->precision = spec->precision*10 + (*fmt - '0');
+		}
+	}
 
-	/* Fill up with zeros. */
-	if (divisor == 16)
+	plain = (spec->flags == 0) && (spec->width == FMT_NONE) && (spec->precision == FMT_NONE);
+
+	/* Length modifier. */
+	if (*fmt == 'h')
+	{
+		spec->length = (*(++fmt) == 'h') ? FMT_LEN_HH : FMT_LEN_H;
+		fmt += (spec->length == FMT_LEN_HH);
+	}
+	else if (*fmt == 'l')
 	{
-		while ((p - b) < 8)
-			*p++ = '0';
+		spec->length = (*(++fmt) == 'l') ? FMT_LEN_LL : FMT_LEN_L;
+		fmt += (spec->length == FMT_LEN_LL);
+	}
+	else if (*fmt == 'z')
+	{
+		spec->length = FMT_LEN_Z;
+		fmt++;
+	}
+	else if (*fmt == 'L')
+	{
+		spec->length = FMT_LEN_Q;
+		fmt++;
 	}
 
-	/* Reverse BUF. */
-	p1 = b; p2 = p - 1;
-	while (p1 < p2)
+	/* Conversion. */
+	spec->conv = *fmt;
+	switch (*fmt)
 	{
-		char tmp = *p1;
-		*p1++ = *p2;
-		*p2-- = tmp;
+		case 'd':
+		case 'i':
+			if (spec->length == FMT_LEN_LL || spec->length == FMT_LEN_Q)
+				spec->arg = FMT_ARG_LLONG;
+			else if (spec->length == FMT_LEN_L || spec->length == FMT_LEN_Z)
+				spec->arg = FMT_ARG_LONG;
+			else
+				spec->arg = FMT_ARG_INT;
+			break;
+		case 'x':
+		case 'X':
+		case 'o':
+		case 'u':
+			if (spec->length == FMT_LEN_LL || spec->length == FMT_LEN_Q)
+				spec->arg = FMT_ARG_LLONG;
+			else if (spec->length == FMT_LEN_L)
+				spec->arg = FMT_ARG_ULONG;
+			else
+				spec->arg = (spec->length == FMT_LEN_Z) ? FMT_ARG_SIZE : FMT_ARG_UINT;
+
+			/* Legacy 0x-prefixed hex number. */
+			if (plain && (spec->conv == 'x'))
+			{
+				if (spec->length == FMT_LEN_NONE)
+				{
+					spec->flags = FMT_LEGACY;
+					spec->precision = 8;
+				}
+				else if (spec->length == FMT_LEN_L)
+				{
+					spec->flags = FMT_LEGACY;
+					spec->precision = 2*sizeof(long);
+				}
+				else if (spec->length == FMT_LEN_Q)
+				{
+					spec->flags = FMT_LEGACY;
+					spec->precision = 16;
+				}
+			}
+			break;
+		case 'c':
+			spec->arg = FMT_ARG_INT;
+			break;
+		case 'p':
+		case 's':
+			spec->arg = FMT_ARG_PTR;
+			break;
+		case '%':
+			spec->arg = FMT_ARG_NONE;
+			break;
+		default:
+			/* Legacy unsigned integer. */
+			if (spec->length == FMT_LEN_L || spec->length == FMT_LEN_Q)
+			{
+				spec->conv = 'u';
+				spec->arg = (spec->length == FMT_LEN_Q) ? FMT_ARG_LLONG : FMT_ARG_ULONG;
+				return (fmt);
+			}
+
+			/* Unknown or dangling conversion. */
+			spec->conv = 0;
+			spec->arg = FMT_ARG_NONE;
+			return ((*fmt == '\0') ? fmt : fmt + 1);
 	}
 
-	return(p - str);
+	return (fmt + 1);
 }
 
-#ifndef __qemu_riscv32__
+/**
+ * @brief Size (in bytes) of the staging buffer of the formatter.
+ */
+#define CBPRINTF_CHUNK_SIZE 64
+
+/**
+ * @brief State of the formatter.
+ */
+struct cbprintf_state
+{
+	fmt_sink_t write;                /**< Output sink.              */
+	void *ctx;                       /**< Context of output sink.   */
+	char buf[CBPRINTF_CHUNK_SIZE];   /**< Staging buffer.           */
+	size_t used;                     /**< Used bytes in buf.        */
+	int len;                         /**< Number of emitted bytes.  */
+};
 
 /**
- * @brief Converts an 64 bit integer to a string.
+ * @brief Flushes the staging buffer of the formatter.
  *
- * @param str  Output string.
- * @param num  Number to be converted.
- * @param base Base to use.
+ * @param st Formatter state.
+ */
+static void cbprintf_flush(struct cbprintf_state *st)
+{
+	if (st->used > 0)
+	{
+		st->write(st->ctx, st->buf, st->used);
+		st->used = 0;
+	}
+}
+
+/**
+ * @brief Emits characters through the formatter.
  *
- * @returns The length of the output string.
+ * @details Short runs are staged and flushed in chunks. Runs that do
+ * not fit in the staging buffer are handed to the sink in place.
+ *
+ * @param st  Formatter state.
+ * @param buf Characters to emit.
+ * @param len Number of characters in @p buf.
  */
-static int itoa64(char *str, UNSIGNED_T num, int base)
+static void cbprintf_emit(struct cbprintf_state *st, const char *buf, size_t len)
 {
-	char *b = str;
-	char *p, *p1, *p2;
-	unsigned divisor;
+	st->len += len;
 
-#if (__HAS_HW_DIVISION)
+	if (len > (CBPRINTF_CHUNK_SIZE - st->used))
+	{
+		cbprintf_flush(st);
 
-	divisor = 10;
+		if (len >= CBPRINTF_CHUNK_SIZE)
+		{
+			st->write(st->ctx, buf, len);
+			return;
+		}
+	}
+
+	__memcpy(&st->buf[st->used], buf, len);
+	st->used += len;
+}
 
-	if (base == 'h')
+/**
+ * @brief Arguments of the formatter.
+ *
+ * @details Arguments come either from a variable arguments list or,
+ * when @p words is not NULL, from an array of raw argument words.
+ */
+struct fmt_args
+{
+	va_list ap;            /**< Variable arguments list. */
+	const uint64_t *words; /**< Raw argument words.      */
+	unsigned nwords;       /**< Number of words left.    */
+};
+
+/**
+ * @brief Fetches the next argument.
+ *
+ * @details Signed arguments are sign-extended, so the returned word can
+ * be stored and later fetched back as a raw argument word.
+ *
+ * @param args Arguments of the formatter.
+ * @param kind Kind of argument.
+ *
+ * @returns The next argument, or zero if there are none left.
+ */
+static UNSIGNED_T fmt_args_fetch(struct fmt_args *args, unsigned kind)
+{
+	/* Raw argument word. */
+	if (args->words != NULL)
 	{
-		divisor = 16;
-		*b++ = '0';
-		*b++ = 'x';
-	}
+		if (args->nwords == 0)
+			return (0);
+
+		args->nwords--;
 
-	p = b;
+		return (*args->words++);
+	}
 
-	/* Convert number. */
-	do
+	switch (kind)
 	{
-		UNSIGNED_T remainder;
+		case FMT_ARG_INT:
+			return ((UNSIGNED_T)(long long)va_arg(args->ap, int));
+		case FMT_ARG_UINT:
+			return (va_arg(args->ap, unsigned));
+		case FMT_ARG_LONG:
+			return ((UNSIGNED_T)(long long)va_arg(args->ap, long));
+		case FMT_ARG_ULONG:
+			return (va_arg(args->ap, unsigned long));
+		case FMT_ARG_SIZE:
+			return (va_arg(args->ap, size_t));
+		case FMT_ARG_LLONG:
+			return (va_arg(args->ap, UNSIGNED_T));
+		case FMT_ARG_PTR:
+			return ((unsigned long)va_arg(args->ap, const void *));
+		default:
+			break;
+	}
 
-#ifdef __GLIBC_BUG__
-		remainder = (divisor == 10 ? (num % 10) : (num % 16));
-#else
-		remainder = num % divisor;
-#endif
+	return (0);
+}
 
-		*p++ = (remainder < 10) ?
-			remainder + '0' : remainder + 'a' - 10;
+/**
+ * @brief Emits a run of padding characters through the formatter.
+ *
+ * @param st Formatter state.
+ * @param c  Padding character (either a space or a zero).
+ * @param n  Number of padding characters.
+ */
+static void cbprintf_pad(struct cbprintf_state *st, char c, int n)
+{
+	static const char spaces[17] = "                ";
+	static const char zeros[17] = "0000000000000000";
+	const char *run = (c == '0') ? zeros : spaces;
 
-#ifdef __GLIBC_BUG__
-	} while ((divisor == 10 ? (num /= 10) : (num /= 16)));
-#else
-	} while (num /= divisor);
-#endif
+	for (/* noop */; n > 16; n -= 16)
+		cbprintf_emit(st, run, 16);
 
-#else
+	if (n > 0)
+		cbprintf_emit(st, run, n);
+}
 
-	((void) base);
+/**
+ * @brief Emits a field through the formatter, justified within its width.
+ *
+ * @param st    Formatter state.
+ * @param flags Flags of the conversion.
+ * @param width Minimum field width.
+ * @param buf   Characters of the field.
+ * @param len   Number of characters in @p buf.
+ */
+static void cbprintf_field(struct cbprintf_state *st, unsigned flags, int width, const char *buf, size_t len)
+{
+	int pad = ((size_t)width > len) ? width - (int)len : 0;
 
-	divisor = 16;
-	*b++ = '0'; *b++ = 'x';
+	if (!(flags & FMT_LEFT))
+		cbprintf_pad(st, ' ', pad);
 
-	/* Convert number. */
-	do
-	{
-		UNSIGNED_T remainder = num & 0xf;
+	cbprintf_emit(st, buf, len);
 
-		*p++ = (remainder < 10) ?
-			remainder + '0' : remainder + 'a' - 10;
-	} while ((num  = (num >> 4)));
+	if (flags & FMT_LEFT)
+		cbprintf_pad(st, ' ', pad);
+}
 
-#endif
+/**
+ * @brief Emits an integer through the formatter.
+ *
+ * @details Sign, prefix, zeros and digits are laid out in a single
+ * step, from the lengths of the parts.
+ *
+ * @param st   Formatter state.
+ * @param spec Conversion specification, with width and precision resolved.
+ * @param num  Magnitude of the integer.
+ * @param sign Sign character, or zero if none.
+ */
+static void cbprintf_integer(struct cbprintf_state *st, const struct fmt_spec *spec, UNSIGNED_T num, char sign)
+{
+	char tmp[24];
+	int ndigits;
+	int zeros;
+	int len;
+	const char *prefix = NULL;
+
+	/* Digits. */
+	if ((num == 0) && (spec->precision == 0))
+		ndigits = 0;
+	else if (spec->conv == 'x' || spec->conv == 'p')
+		ndigits = btoa(tmp, num, 4, hex_digits);
+	else if (spec->conv == 'X')
+		ndigits = btoa(tmp, num, 4, hex_digits_upper);
+	else if (spec->conv == 'o')
+		ndigits = btoa(tmp, num, 3, hex_digits);
+	else
+		ndigits = utoa(tmp, num, count_digits(num));
 
+	zeros = (spec->precision > ndigits) ? spec->precision - ndigits : 0;
 
-	/* Fill up with zeros. */
-	if (divisor == 16)
+	/* Prefix. */
+	if ((spec->flags & FMT_LEGACY) || (spec->conv == 'p'))
+		prefix = "0x";
+	else if ((spec->flags & FMT_ALT) && (num != 0))
 	{
-		while ((p - b) < 16)
-			*p++ = '0';
+		if (spec->conv == 'x')
+			prefix = "0x";
+		else if (spec->conv == 'X')
+			prefix = "0X";
 	}
+	if ((spec->flags & FMT_ALT) && (spec->conv == 'o'))
+	{
+		if ((zeros == 0) && ((ndigits == 0) || (tmp[0] != '0')))
+			zeros = 1;
+	}
+
+	len = (sign != 0) + ((prefix != NULL) ? 2 : 0) + zeros + ndigits;
 
-	/* Reverse BUF. */
-	p1 = b; p2 = p - 1;
-	while (p1 < p2)
+	/* Zero padding. */
+	if (((spec->flags & (FMT_ZERO | FMT_LEFT)) == FMT_ZERO) && (spec->precision < 0))
 	{
-		char tmp = *p1;
-		*p1++ = *p2;
-		*p2-- = tmp;
+		if (spec->width > len)
+		{
+			zeros += spec->width - len;
+			len = spec->width;
+		}
 	}
 
-	return(p - str);
-}
+	if (!(spec->flags & FMT_LEFT))
+		cbprintf_pad(st, ' ', spec->width - len);
 
-#endif /* !qemu_riscv32 */
+	if (sign != 0)
+		cbprintf_emit(st, &sign, 1);
+	if (prefix != NULL)
+		cbprintf_emit(st, prefix, 2);
+	cbprintf_pad(st, '0', zeros);
+	cbprintf_emit(st, tmp, ndigits);
+
+	if (spec->flags & FMT_LEFT)
+		cbprintf_pad(st, ' ', spec->width - len);
+}
 
- /**
- * @brief Count number of digits a number has.
+/**
+ * @brief Performs a conversion through the formatter.
  *
- * @param num Number to have digits counted.
+ * @param st   Formatter state.
+ * @param spec Conversion specification.
+ * @param args Arguments of the formatter.
+ */
+static void cbprintf_conv(struct cbprintf_state *st, struct fmt_spec spec, struct fmt_args *args)
+{
+	char c;
+	const char *s;
+	size_t len;
+	long long snum;
+	UNSIGNED_T num;
+
+	/* Field width and precision from the arguments list. */
+	if (spec.width == FMT_STAR)
+	{
+		spec.width = (int)fmt_args_fetch(args, FMT_ARG_INT);
+		if (spec.width < 0)
+		{
+			spec.flags |= FMT_LEFT;
+			spec.width = -spec.width;
+		}
+	}
+	if (spec.precision == FMT_STAR)
+	{
+		spec.precision = (int)fmt_args_fetch(args, FMT_ARG_INT);
+		if (spec.precision < 0)
+			spec.precision = FMT_NONE;
+	}
+
+	switch (spec.conv)
+	{
+		/* Signed integer. */
+		case 'd':
+		case 'i':
+			snum = (long long)fmt_args_fetch(args, spec.arg);
+			if (spec.length == FMT_LEN_HH)
+				snum = (signed char)snum;
+			else if (spec.length == FMT_LEN_H)
+				snum = (short)snum;
+
+			if (snum < 0)
+				c = '-';
+			else if (spec.flags & FMT_PLUS)
+				c = '+';
+			else
+				c = (spec.flags & FMT_SPACE) ? ' ' : 0;
+
+			num = (snum < 0) ? -(UNSIGNED_T)snum : (UNSIGNED_T)snum;
+			cbprintf_integer(st, &spec, num, c);
+			break;
+		/* Unsigned integer. */
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+			num = fmt_args_fetch(args, spec.arg);
+			if (spec.length == FMT_LEN_HH)
+				num = (unsigned char)num;
+			else if (spec.length == FMT_LEN_H)
+				num = (unsigned short)num;
+			cbprintf_integer(st, &spec, num, 0);
+			break;
+		/* Pointer. */
+		case 'p':
+			cbprintf_integer(st, &spec, fmt_args_fetch(args, spec.arg), 0);
+			break;
+		/* Character. */
+		case 'c':
+			c = (char)fmt_args_fetch(args, spec.arg);
+			cbprintf_field(st, spec.flags, spec.width, &c, 1);
+			break;
+		/* String. */
+		case 's':
+			s = (const char *)(unsigned long)fmt_args_fetch(args, spec.arg);
+			if (s == NULL)
+				s = "(null)";
+			len = (spec.precision >= 0) ? __strnlen(s, spec.precision) : __strlen(s);
+			cbprintf_field(st, spec.flags, spec.width, s, len);
+			break;
+		/* Percent sign. */
+		case '%':
+			cbprintf_emit(st, "%", 1);
+			break;
+		/* Ignore. */
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief Formats a string into the staging buffer of the formatter.
  *
- * @returns Number of digits of num.
+ * @param st   Formatter state.
+ * @param fmt  Formatted string.
+ * @param args Arguments of the formatter.
  */
-static unsigned count_digits(UNSIGNED_T num)
+static void cbprintf_format(struct cbprintf_state *st, const char *fmt, struct fmt_args *args)
 {
-	unsigned digits = 0;
-	while (num != 0)
+	const char *s;
+	struct fmt_spec spec;
+
+	/* Format string. */
+	while (*fmt != '\0')
 	{
-#if (__HAS_HW_DIVISION)
-		num /= 10;
-#else
-		UNSIGNED_T quocient = 0;
-		UNSIGNED_T dividend = num;
-		while (dividend >= 10)
+		/* No conversion needed. */
+		if (*fmt != '%')
 		{
-			dividend -= 10;
-			quocient++;
+			for (s = fmt; *fmt != '\0' && *fmt != '%'; fmt++)
+				/* No operation. */;
+
+			cbprintf_emit(st, s, fmt - s);
+			continue;
 		}
 
-		num = quocient;
-#endif
-		++digits;
+		fmt = fmt_parse(fmt + 1, &spec);
+		cbprintf_conv(st, spec, args);
 	}
+}
+
+/**
+ * @brief Formats a string into an output sink.
+ *
+ * @details Literal runs of @p fmt, converted numbers and strings are
+ * handed to @p write in chunks, so output can be streamed straight to
+ * a device or a ring buffer, without an intermediate buffer or a size
+ * cap.
+ *
+ * Conversions follow C99: the %d, %i, %u, %x, %X, %o, %p, %c, %s and
+ * %% conversions, the -, 0, +, space and # flags, field width and
+ * precision (possibly given as *), and the hh, h, l, ll and z length
+ * modifiers. Floating-point conversions are not supported. The legacy
+ * forms %l, %x and %lx, and the legacy L modifier, are kept (see
+ * fmt_parse()).
+ *
+ * @note Every use of the l modifier takes a long, which is 32-bit on
+ * ILP32 targets (e.g. riscv32 and mppa256). Callers there that print
+ * 64-bit integers with a bare %l or a plain %lx must switch to %L and
+ * %Lx, or to %llu and %llx.
+ *
+ * @param write Output sink.
+ * @param ctx   Context passed to @p write.
+ * @param fmt   Formatted string.
+ * @param args  Variable arguments list.
+ *
+ * @returns The number of characters emitted, or -1 if @p write or
+ * @p fmt is NULL.
+ */
+int __vcbprintf(fmt_sink_t write, void *ctx, const char *fmt, va_list args)
+{
+	struct cbprintf_state st;
+	struct fmt_args fargs;
+
+	if (write == NULL || fmt == NULL)
+		return (-1);
+
+	st.write = write;
+	st.ctx = ctx;
+	st.used = 0;
+	st.len = 0;
+
+	va_copy(fargs.ap, args);
+	fargs.words = NULL;
+	fargs.nwords = 0;
+
+	cbprintf_format(&st, fmt, &fargs);
+	cbprintf_flush(&st);
+
+	va_end(fargs.ap);
+
+	return (st.len);
+}
 
-	return digits;
+/**
+ * @brief Formats a string into an output sink.
+ *
+ * @param write Output sink.
+ * @param ctx   Context passed to @p write.
+ * @param fmt   Formatted string.
+ *
+ * @returns The number of characters emitted, or -1 if @p write or
+ * @p fmt is NULL.
+ */
+int __cbprintf(fmt_sink_t write, void *ctx, const char *fmt, ...)
+{
+	int len;
+	va_list args;
+
+	va_start(args, fmt);
+	len = __vcbprintf(write, ctx, fmt, args);
+	va_end(args);
+
+	return (len);
+}
+
+/**
+ * @brief Output sink of __vsnprintf().
+ */
+struct snprintf_sink
+{
+	char *str;   /**< Next position in output string. */
+	size_t left; /**< Room left in output string.     */
+};
+
+/**
+ * @brief Copies formatted characters into a string, truncating them.
+ *
+ * @param ctx Output sink (struct snprintf_sink).
+ * @param buf Formatted characters.
+ * @param len Number of characters in @p buf.
+ */
+static void snprintf_write(void *ctx, const char *buf, size_t len)
+{
+	struct snprintf_sink *sink = ctx;
+
+	if (len > sink->left)
+		len = sink->left;
+
+	sink->left -= len;
+
+	__memcpy(sink->str, buf, len);
+	sink->str += len;
 }
 
 /**
  * @brief Writes at most size bytes (including the terminating null byte ('\0'))
  * of formatted data to str. If the the result is larger than size, the output
- * string will be truncated. If a number needs to be truncated, not even the
- * part that fits in the output will be written, so no number will be in the output.
+ * string will be truncated.
+ *
+ * @details If @p size is zero, nothing is written and @p str may be
+ * NULL, so the function can be used to query the size of the output.
  *
  * @param str	Output string.
  * @param size	Write at most size bytes (including null byte).
  * @param fmt	Formatted string.
  * @param args	Variable arguments list.
  *
- * @returns Length of output string (excluding terminating null byte). If size is 0
- *  or fmt string is NULL or empty, the function returns -1.
- *
- * @todo TODO: Should return the length the string would have had if it wasn't truncated.
+ * @returns Length that the output string would have had if it was not
+ * truncated (excluding terminating null byte). If fmt string is NULL, the
+ * function returns -1.
  */
 int __vsnprintf(char *str, size_t size, const char *fmt, va_list args)
 {
-	char *base = str;
-	char *s;
-	UNSIGNED_T number;
+	int len;
+	struct snprintf_sink sink;
 
-	if (size == 0 || fmt == NULL)
+	if (fmt == NULL)
 		return (-1);
 
-	/* Format string. */
-	while (*fmt != '\0' && (size_t)(str - base) < (size - 1))
+	sink.str = str;
+	sink.left = (size > 0) ? size - 1 : 0;
+
+	len = __vcbprintf(snprintf_write, &sink, fmt, args);
+
+	if (size > 0)
+		*sink.str = '\0';
+
+	return (len);
+}
+
+/*============================================================================*
+ * Precompiled Formats                                                        *
+ *============================================================================*/
+
+/**
+ * The fmt_compile() function parses the format string pointed to by
+ * @p fmt into the format descriptor pointed to by @p desc. Literal runs
+ * are recorded by address, so @p fmt must outlive the descriptor.
+ */
+int fmt_compile(fmt_desc_t *desc, const char *fmt)
+{
+	const char *s;
+	fmt_op_t *op;
+	struct fmt_spec spec;
+
+	if (fmt == NULL)
+		return (-1);
+
+	for (desc->nops = 0; *fmt != '\0'; /* noop */)
 	{
-		/* No conversion needed. */
+		if (desc->nops >= FMT_DESC_MAX_OPS)
+			return (-1);
+
+		op = &desc->ops[desc->nops];
+
+		/* Literal run. */
 		if (*fmt != '%')
-			*str++ = *fmt;
-		else
 		{
-			switch (*(++fmt))
-			{
-				/* Character. */
-				case 'c':
-					*str++ = (char)va_arg(args, int);
-					break;
-				/* Number. */
-				case 'd':
-					number = va_arg(args, unsigned);
-					if ((size_t)(count_digits(number) + (str - base)) <= (size - 1))
-						str += itoa(str, number, *fmt);
-					break;
-				case 'x':
-					/* Hex numbers are currently being converted
-					 * using always 0x + 8 digits. */
-					if ((size_t)(10 + (str - base)) <= (size - 1))
-						str += itoa(str, va_arg(args, unsigned), *fmt);
-					break;
-#ifndef __qemu_riscv32__
-				case 'l':
-					if(*(fmt + 1) == 'x')
-					{
-						/* Long hex numbers are currently being converted
-						 * using always 0x + 16 digits. */
-						if ((size_t)(18 + (str - base)) <= (size - 1))
-							str += itoa64(str, va_arg(args, UNSIGNED_T), 'h');
-						++fmt;
-					}
-					else
-					{
-						number = va_arg(args, UNSIGNED_T);
-						if ((size_t)(count_digits(number) + (str - base)) <= (size - 1))
-							str += itoa64(str, number, 'l');
-					}
-					break;
-#endif
-				/* String. */
-				case 's':
-					s = va_arg(args, char*);
-					while (*s != '\0' && (size_t)(str - base) < (size - 1))
-						*str++ = *s++;
-					break;
-				/* Ignore. */
-				default:
-					break;
-			}
+			for (s = fmt; *fmt != '\0' && *fmt != '%'; fmt++)
+				/* No operation. */;
+
+			op->lit = s;
+			op->len = fmt - s;
+			desc->nops++;
+			continue;
+		}
+
+		/* Escaped percent sign. */
+		if (*(fmt + 1) == '%')
+		{
+			op->lit = fmt;
+			op->len = 1;
+			fmt += 2;
+			desc->nops++;
+			continue;
 		}
 
-		++fmt;
+		fmt = fmt_parse(fmt + 1, &spec);
+
+		/* Unknown or dangling conversion. */
+		if (spec.conv == 0)
+			continue;
+
+		op->lit = NULL;
+		op->len = 0;
+		op->conv = spec.conv;
+		op->flags = spec.flags;
+		op->length = spec.length;
+		op->arg = spec.arg;
+		op->width = spec.width;
+		op->precision = spec.precision;
+		desc->nops++;
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Formats arguments with a format descriptor into the staging
+ * buffer of the formatter.
+ *
+ * @param st   Formatter state.
+ * @param desc Format descriptor.
+ * @param args Arguments of the formatter.
+ */
+static void cbprintf_exec(struct cbprintf_state *st, const fmt_desc_t *desc, struct fmt_args *args)
+{
+	const fmt_op_t *op;
+	struct fmt_spec spec;
+
+	for (op = desc->ops; op < &desc->ops[desc->nops]; op++)
+	{
+		/* Literal run. */
+		if (op->lit != NULL)
+		{
+			cbprintf_emit(st, op->lit, op->len);
+			continue;
+		}
+
+		spec.conv = op->conv;
+		spec.flags = op->flags;
+		spec.length = op->length;
+		spec.arg = op->arg;
+		spec.width = op->width;
+		spec.precision = op->precision;
+		cbprintf_conv(st, spec, args);
+	}
+}
+
+/**
+ * @brief Formats arguments with a format descriptor into an output sink.
+ *
+ * @param write Output sink.
+ * @param ctx   Context passed to @p write.
+ * @param desc  Format descriptor.
+ * @param args  Variable arguments list.
+ *
+ * @returns The number of characters emitted.
+ */
+static int fmt_vcbprintf(fmt_sink_t write, void *ctx, const fmt_desc_t *desc, va_list args)
+{
+	struct cbprintf_state st;
+	struct fmt_args fargs;
+
+	st.write = write;
+	st.ctx = ctx;
+	st.used = 0;
+	st.len = 0;
+
+	va_copy(fargs.ap, args);
+	fargs.words = NULL;
+	fargs.nwords = 0;
+
+	cbprintf_exec(&st, desc, &fargs);
+	cbprintf_flush(&st);
+
+	va_end(fargs.ap);
+
+	return (st.len);
+}
+
+/**
+ * The fmt_cbprintf() function formats its arguments as described by the
+ * format descriptor pointed to by @p desc, into the output sink
+ * @p write.
+ */
+int fmt_cbprintf(fmt_sink_t write, void *ctx, const fmt_desc_t *desc, ...)
+{
+	int len;
+	va_list args;
+
+	if (write == NULL || desc == NULL)
+		return (-1);
+
+	va_start(args, desc);
+	len = fmt_vcbprintf(write, ctx, desc, args);
+	va_end(args);
+
+	return (len);
+}
+
+/**
+ * The fmt_snprintf() function formats its arguments as described by the
+ * format descriptor pointed to by @p desc, into at most @p size bytes
+ * (including the terminating null byte) of the string pointed to by
+ * @p str. As in __vsnprintf(), a zero @p size only computes the length.
+ */
+int fmt_snprintf(char *str, size_t size, const fmt_desc_t *desc, ...)
+{
+	int len;
+	va_list args;
+	struct snprintf_sink sink;
+
+	if (desc == NULL)
+		return (-1);
+
+	sink.str = str;
+	sink.left = (size > 0) ? size - 1 : 0;
+
+	va_start(args, desc);
+	len = fmt_vcbprintf(snprintf_write, &sink, desc, args);
+	va_end(args);
+
+	if (size > 0)
+		*sink.str = '\0';
+
+	return (len);
+}
+
+/*============================================================================*
+ * Binary Logging                                                             *
+ *============================================================================*/
+
+/**
+ * The binlog_init() function initializes the binary log pointed to by
+ * @p log, on top of the array of @p nrecords records pointed to by
+ * @p records. If @p clock is not NULL, it timestamps every record. The
+ * number of records is a power of two, so that records are indexed
+ * with a mask rather than with a division.
+ */
+int binlog_init(binlog_t *log, binlog_record_t *records, size_t nrecords, uint64_t (*clock)(void))
+{
+	/* Not a power of two. */
+	if ((nrecords == 0) || (nrecords & (nrecords - 1)))
+		return (-1);
+
+	log->records = records;
+	log->nrecords = nrecords;
+	log->head = 0;
+	log->tail = 0;
+	log->dropped = 0;
+	log->clock = clock;
+
+	return (0);
+}
+
+/**
+ * The __binlog() function appends a record to the binary log pointed to
+ * by @p log. The record holds only the address of @p desc, a timestamp
+ * and the raw words of up to #BINLOG_MAX_ARGS arguments; neither parsing
+ * nor formatting takes place. Strings are recorded by address, so they
+ * must outlive the record. If the log is full, the record is dropped and
+ * counted.
+ */
+int __binlog(binlog_t *log, const fmt_desc_t *desc, ...)
+{
+	binlog_record_t *rec;
+	const fmt_op_t *op;
+	unsigned nargs = 0;
+	unsigned nwords;
+	struct fmt_args fargs;
+
+	/* Log is full. */
+	if ((log->tail - log->head) >= log->nrecords)
+	{
+		log->dropped++;
+		return (-1);
+	}
+
+	rec = &log->records[log->tail & (log->nrecords - 1)];
+
+	/* Copy raw arguments, as consumed by the formatter. */
+	va_start(fargs.ap, desc);
+	fargs.words = NULL;
+	fargs.nwords = 0;
+	for (op = desc->ops; op < &desc->ops[desc->nops]; op++)
+	{
+		/* Literal run. */
+		if (op->lit != NULL)
+			continue;
+
+		nwords = (op->width == FMT_STAR) + (op->precision == FMT_STAR) +
+			(op->arg != FMT_ARG_NONE);
+
+		/* Too many arguments. */
+		if ((nargs + nwords) > BINLOG_MAX_ARGS)
+		{
+			va_end(fargs.ap);
+			return (-1);
+		}
+
+		if (op->width == FMT_STAR)
+			rec->args[nargs++] = fmt_args_fetch(&fargs, FMT_ARG_INT);
+		if (op->precision == FMT_STAR)
+			rec->args[nargs++] = fmt_args_fetch(&fargs, FMT_ARG_INT);
+		if (op->arg != FMT_ARG_NONE)
+			rec->args[nargs++] = fmt_args_fetch(&fargs, op->arg);
+	}
+	va_end(fargs.ap);
+
+	rec->desc = desc;
+	rec->timestamp = (log->clock != NULL) ? log->clock() : 0;
+
+	rec->nargs = nargs;
+	log->tail++;
+
+	return (0);
+}
+
+/**
+ * The binlog_drain() function formats all records of the binary log
+ * pointed to by @p log, oldest first, into the output sink @p write.
+ * Each message is prefixed with its timestamp between brackets.
+ */
+int binlog_drain(binlog_t *log, fmt_sink_t write, void *ctx)
+{
+	int n = 0;
+	struct cbprintf_state st;
+	struct fmt_args fargs;
+
+	if (write == NULL)
+		return (-1);
+
+	st.write = write;
+	st.ctx = ctx;
+	st.used = 0;
+	st.len = 0;
+
+	for (/* noop */; log->head != log->tail; log->head++, n++)
+	{
+		const binlog_record_t *rec;
+		uint64_t timestamp;
+
+		rec = &log->records[log->head & (log->nrecords - 1)];
+
+		/* Timestamp. */
+		timestamp = rec->timestamp;
+		fargs.words = &timestamp;
+		fargs.nwords = 1;
+		cbprintf_format(&st, "[%llu] ", &fargs);
+
+		/* Message. */
+		fargs.words = rec->args;
+		fargs.nwords = rec->nargs;
+		cbprintf_exec(&st, rec->desc, &fargs);
 	}
 
-	*str = '\0';
+	cbprintf_flush(&st);
 
-	return ((str - base) - 1);
+	return (n);
 }